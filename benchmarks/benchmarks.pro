@@ -0,0 +1,31 @@
+#-------------------------------------------------
+#
+# Benchmarks of the pickers, running on the offscreen platform:
+#
+#   qmake && make && ./picker2benchmark [--repeat N] [--size WxH]
+#
+# The library has to be built in the parent directory before.
+#
+#-------------------------------------------------
+
+QT       += gui
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = picker2benchmark
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ..
+DEPENDPATH += ..
+
+SOURCES += \
+    picker2benchmark.cpp
+
+LIBS += -L$$OUT_PWD/.. -lqwt-rmb
+unix:QMAKE_RPATHDIR += $$OUT_PWD/..
+
+unix:CONFIG += qwt
+unix:INCLUDEPATH += /usr/include/qwt /usr/include/Qt
+unix:LIBS += -lqwt
@@ -0,0 +1,1022 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+/*
+    Benchmarks of the pickers, running on the offscreen platform.
+
+    - the transitions of the state machines: time and heap allocations
+      per mouse move. The DragRect and Polygon machines are expected
+      to process moves without any allocation, otherwise the benchmark
+      fails with exit code 1.
+
+    - the coordinate transformations of QwtPlotPicker2 compared to
+      fetching the scale maps from the plot for each point, like
+      it has been done before the maps were cached.
+
+    - a sweep of the line rubber bands over a 4K canvas: painted
+      pixels of the overlays per mouse move.
+
+    - scripted streams of press/move/release/wheel/key events, that are
+      sent to QwtPicker2 and QwtPlotPicker2 on a plot canvas for each state
+      machine, rubber band and tracker mode. Each event is followed by
+      processing the pending paint events. Reported are events per second,
+      latency percentiles per event, heap allocations per event, painted
+      pixels of the overlays per mouse move and the average time for
+      painting an overlay.
+ */
+
+#include "qwt_picker2.h"
+#include "qwt_plot_picker2.h"
+#include "qwt_picker_machine2.h"
+
+#include "qwt_plot.h"
+#include "qwt_plot_curve.h"
+#include "qwt_scale_map.h"
+#include "qwt_event_pattern.h"
+#include "qwt_widget_overlay.h"
+#include "qwt_math.h"
+
+#include <qapplication.h>
+#include <qelapsedtimer.h>
+#include <qevent.h>
+#include <qatomic.h>
+#include <qregion.h>
+#include <qvector.h>
+#include <qstringlist.h>
+#include <qtextstream.h>
+#include <qpen.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if __cplusplus < 201103L
+#define QWT_BAD_ALLOC throw( std::bad_alloc )
+#define QWT_NOTHROW throw()
+#else
+#define QWT_BAD_ALLOC
+#define QWT_NOTHROW noexcept
+#endif
+
+/*
+    Counting heap allocations. With glibc the allocation functions of
+    the C library are interposed, so that all allocations are counted:
+    operator new as well as the malloc/realloc calls of the Qt containers.
+    Otherwise only the allocations by operator new are counted.
+
+    Allocations of other threads are counted as well, but the
+    offscreen platform does not run any while processing events.
+ */
+static QBasicAtomicInt qwtAllocationCount = Q_BASIC_ATOMIC_INITIALIZER( 0 );
+
+#if defined( __GLIBC__ )
+
+#define QWT_COUNTED_ALLOCATIONS "calls of malloc, calloc and realloc"
+
+extern "C"
+{
+    void* __libc_malloc( size_t );
+    void* __libc_calloc( size_t, size_t );
+    void* __libc_realloc( void*, size_t );
+
+    void* malloc( size_t size ) QWT_NOTHROW
+    {
+        qwtAllocationCount.fetchAndAddRelaxed( 1 );
+        return __libc_malloc( size );
+    }
+
+    void* calloc( size_t count, size_t size ) QWT_NOTHROW
+    {
+        qwtAllocationCount.fetchAndAddRelaxed( 1 );
+        return __libc_calloc( count, size );
+    }
+
+    void* realloc( void* p, size_t size ) QWT_NOTHROW
+    {
+        qwtAllocationCount.fetchAndAddRelaxed( 1 );
+        return __libc_realloc( p, size );
+    }
+}
+
+#else
+
+#define QWT_COUNTED_ALLOCATIONS "calls of operator new only"
+
+void* operator new( std::size_t size ) QWT_BAD_ALLOC
+{
+    qwtAllocationCount.fetchAndAddRelaxed( 1 );
+
+    void* p = std::malloc( size > 0 ? size : 1 );
+    if ( p == NULL )
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new[]( std::size_t size ) QWT_BAD_ALLOC
+{
+    return operator new( size );
+}
+
+void operator delete( void* p ) QWT_NOTHROW
+{
+    std::free( p );
+}
+
+void operator delete[]( void* p ) QWT_NOTHROW
+{
+    std::free( p );
+}
+
+#endif
+
+// results of loops, that should not be optimized away
+static volatile double qwtSink;
+
+static inline int qwtAllocations()
+{
+    return qwtAllocationCount.fetchAndAddRelaxed( 0 );
+}
+
+namespace
+{
+    // an event of a scripted stream
+    class ScriptEvent
+    {
+      public:
+        QEvent::Type type;
+        QPoint pos;
+        int code; // button or key
+        Qt::MouseButtons buttons;
+        Qt::KeyboardModifiers modifiers;
+        int delta;
+    };
+
+    class Script : public QVector< ScriptEvent >
+    {
+      public:
+        Script( const QwtEventPattern& pattern, const QRect& rect, int repeat )
+            : m_rect( rect )
+            , m_step( 0 )
+        {
+            const QwtEventPattern::MousePattern select =
+                pattern.mousePattern()[ QwtEventPattern::MouseSelect2 ];
+
+            const QVector< QwtEventPattern::KeyPattern >& keys = pattern.keyPattern();
+
+            for ( int i = 0; i < repeat; i++ )
+            {
+                addEvent( QEvent::Enter, nextPos() );
+
+                // hovering
+                for ( int j = 0; j < 50; j++ )
+                    addMove();
+
+                // dragging, with some wheel events
+                addButton( QEvent::MouseButtonPress, select );
+                for ( int j = 0; j < 100; j++ )
+                {
+                    addMove( select.button );
+                    if ( j % 25 == 0 )
+                        addWheel( select.button );
+                }
+                addButton( QEvent::MouseButtonRelease, select );
+
+                // clicking, f.e. for the vertices of a polygon
+                for ( int j = 0; j < 4; j++ )
+                {
+                    for ( int k = 0; k < 25; k++ )
+                        addMove();
+
+                    addButton( QEvent::MouseButtonPress, select );
+                    addButton( QEvent::MouseButtonRelease, select );
+                }
+
+                // selecting by keys
+                addKey( keys[ QwtEventPattern::KeySelect1 ] );
+                for ( int j = 0; j < 10; j++ )
+                {
+                    addKey( keys[ QwtEventPattern::KeyRight ] );
+                    addKey( keys[ QwtEventPattern::KeyDown ] );
+                }
+                addKey( keys[ QwtEventPattern::KeySelect1 ] );
+                addKey( keys[ QwtEventPattern::KeySelect2 ] );
+
+                addEvent( QEvent::Leave, m_pos );
+            }
+        }
+
+      private:
+        QPoint nextPos()
+        {
+            // a Lissajous figure inside of the canvas
+            const double t = 0.01 * m_step++;
+
+            const double x = 0.5 + 0.45 * qSin( 3.0 * t );
+            const double y = 0.5 + 0.45 * qSin( 4.0 * t );
+
+            m_pos = QPoint( m_rect.left() + qRound( x * m_rect.width() ),
+                m_rect.top() + qRound( y * m_rect.height() ) );
+
+            return m_pos;
+        }
+
+        void addEvent( QEvent::Type type, const QPoint& pos,
+            int code = 0, Qt::MouseButtons buttons = Qt::NoButton,
+            Qt::KeyboardModifiers modifiers = Qt::NoModifier, int delta = 0 )
+        {
+            ScriptEvent event;
+            event.type = type;
+            event.pos = pos;
+            event.code = code;
+            event.buttons = buttons;
+            event.modifiers = modifiers;
+            event.delta = delta;
+
+            append( event );
+        }
+
+        void addMove( Qt::MouseButtons buttons = Qt::NoButton )
+        {
+            addEvent( QEvent::MouseMove, nextPos(), Qt::NoButton, buttons );
+        }
+
+        void addWheel( Qt::MouseButtons buttons )
+        {
+            addEvent( QEvent::Wheel, m_pos, 0, buttons, Qt::NoModifier, 120 );
+        }
+
+        void addButton( QEvent::Type type,
+            const QwtEventPattern::MousePattern& pattern )
+        {
+            const Qt::MouseButtons buttons = ( type == QEvent::MouseButtonPress )
+                ? Qt::MouseButtons( pattern.button ) : Qt::MouseButtons( Qt::NoButton );
+
+            addEvent( type, m_pos, pattern.button, buttons, pattern.modifiers );
+        }
+
+        void addKey( const QwtEventPattern::KeyPattern& pattern )
+        {
+            addEvent( QEvent::KeyPress, m_pos, pattern.key,
+                Qt::NoButton, pattern.modifiers );
+            addEvent( QEvent::KeyRelease, m_pos, pattern.key,
+                Qt::NoButton, pattern.modifiers );
+        }
+
+        const QRect m_rect;
+        int m_step;
+        QPoint m_pos;
+    };
+
+    /*
+        Counting the painted pixels of the overlays of a widget and
+        measuring the time for painting them. The paint events are
+        processed inside of the event filter to be able to time them.
+     */
+    class PaintCounter : public QObject
+    {
+      public:
+        explicit PaintCounter( const QWidget* widget )
+            : m_widget( widget )
+            , m_pixels( 0 )
+            , m_paintCount( 0 )
+            , m_paintTime( 0 )
+        {
+        }
+
+        virtual bool eventFilter( QObject* object, QEvent* event ) QWT_OVERRIDE
+        {
+            if ( event->type() == QEvent::Paint && object->parent() == m_widget
+                && dynamic_cast< const QwtWidgetOverlay* >( object ) )
+            {
+                m_pixels += area( static_cast< QPaintEvent* >( event )->region() );
+
+                QElapsedTimer timer;
+                timer.start();
+
+                object->event( event );
+
+                m_paintTime += timer.nsecsElapsed();
+                m_paintCount++;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        qint64 pixels() const
+        {
+            return m_pixels;
+        }
+
+        qint64 paintCount() const
+        {
+            return m_paintCount;
+        }
+
+        qint64 paintTime() const
+        {
+            return m_paintTime;
+        }
+
+      private:
+        static qint64 area( const QRegion& region )
+        {
+            qint64 pixels = 0;
+
+#if QT_VERSION >= 0x050800
+            for ( QRegion::const_iterator it = region.begin();
+                it != region.end(); ++it )
+            {
+                pixels += qint64( it->width() ) * it->height();
+            }
+#else
+            const QVector< QRect > rects = region.rects();
+            for ( int i = 0; i < rects.size(); i++ )
+                pixels += qint64( rects[i].width() ) * rects[i].height();
+#endif
+            return pixels;
+        }
+
+        const QWidget* m_widget;
+        qint64 m_pixels;
+        qint64 m_paintCount;
+        qint64 m_paintTime;
+    };
+
+    // making the transformations accessible
+    class PlotPicker : public QwtPlotPicker2
+    {
+      public:
+        explicit PlotPicker( QWidget* canvas )
+            : QwtPlotPicker2( QwtAxis::XBottom, QwtAxis::YLeft, canvas )
+        {
+        }
+
+        using QwtPlotPicker2::invTransform;
+    };
+
+    class Result
+    {
+      public:
+        int events;
+        qint64 nsecs;
+        QVector< qint64 > latencies; // sorted
+        qint64 allocations;
+        int moves;
+        qint64 movePixels;
+        qint64 paintCount;
+        qint64 paintTime;
+    };
+}
+
+static QwtPicker2Machine* qwtCreateMachine( int index )
+{
+    switch ( index )
+    {
+        case 0:
+            return new QwtPicker2TrackerMachine();
+        case 1:
+            return new QwtPicker2ClickPointMachine();
+        case 2:
+            return new QwtPicker2DragPointMachine();
+        case 3:
+            return new QwtPicker2ClickRectMachine();
+        case 4:
+            return new QwtPicker2DragRectMachine();
+        case 5:
+            return new QwtPicker2DragLineMachine();
+        case 6:
+            return new QwtPicker2PolygonMachine();
+        default:
+            return NULL;
+    }
+}
+
+static const char* qwtMachineName( int index )
+{
+    static const char* names[] =
+    {
+        "Tracker", "ClickPoint", "DragPoint", "ClickRect",
+        "DragRect", "DragLine", "Polygon"
+    };
+
+    return names[index];
+}
+
+static const int qwtMachineCount = 7;
+
+static QString qwtRubberBandName( QwtPicker2::RubberBand rubberBand )
+{
+    switch ( rubberBand )
+    {
+        case QwtPicker2::NoRubberBand:
+            return "None";
+        case QwtPicker2::HLineRubberBand:
+            return "HLine";
+        case QwtPicker2::VLineRubberBand:
+            return "VLine";
+        case QwtPicker2::CrossRubberBand:
+            return "Cross";
+        case QwtPicker2::RectRubberBand:
+            return "Rect";
+        case QwtPicker2::EllipseRubberBand:
+            return "Ellipse";
+        case QwtPicker2::PolygonRubberBand:
+            return "Polygon";
+        default:
+            return QString::number( rubberBand );
+    }
+}
+
+static QString qwtTrackerModeName( QwtPicker2::DisplayMode mode )
+{
+    switch ( mode )
+    {
+        case QwtPicker2::AlwaysOff:
+            return "Off";
+        case QwtPicker2::AlwaysOn:
+            return "On";
+        case QwtPicker2::ActiveOnly:
+            return "ActiveOnly";
+    }
+
+    return QString();
+}
+
+static QVector< QwtPicker2::RubberBand > qwtRubberBands(
+    QwtPicker2Machine::SelectionType selectionType )
+{
+    QVector< QwtPicker2::RubberBand > rubberBands;
+    rubberBands += QwtPicker2::NoRubberBand;
+
+    switch ( selectionType )
+    {
+        case QwtPicker2Machine::PointSelection:
+            rubberBands += QwtPicker2::HLineRubberBand;
+            rubberBands += QwtPicker2::VLineRubberBand;
+            rubberBands += QwtPicker2::CrossRubberBand;
+            break;
+        case QwtPicker2Machine::RectSelection:
+            rubberBands += QwtPicker2::RectRubberBand;
+            rubberBands += QwtPicker2::EllipseRubberBand;
+            break;
+        case QwtPicker2Machine::PolygonSelection:
+            rubberBands += QwtPicker2::PolygonRubberBand;
+            break;
+        default:
+            break;
+    }
+
+    return rubberBands;
+}
+
+static void qwtSendMouseEvent( QWidget* w, QEvent::Type type,
+    const QPoint& pos, Qt::MouseButton button = Qt::NoButton,
+    Qt::MouseButtons buttons = Qt::NoButton,
+    Qt::KeyboardModifiers modifiers = Qt::NoModifier )
+{
+    QMouseEvent event( type, pos, w->mapToGlobal( pos ),
+        button, buttons, modifiers );
+
+    QCoreApplication::sendEvent( w, &event );
+}
+
+static void qwtSendEnterEvent( QWidget* w, const QPoint& pos )
+{
+#if QT_VERSION >= 0x050000
+    QEnterEvent event( pos, w->mapTo( w->window(), pos ),
+        w->mapToGlobal( pos ) );
+#else
+    Q_UNUSED( pos );
+    QEvent event( QEvent::Enter );
+#endif
+    QCoreApplication::sendEvent( w, &event );
+}
+
+static void qwtSendEvent( QWidget* w, const ScriptEvent& scriptEvent )
+{
+    const QPoint& pos = scriptEvent.pos;
+
+    switch ( scriptEvent.type )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseMove:
+        {
+            qwtSendMouseEvent( w, scriptEvent.type, pos,
+                static_cast< Qt::MouseButton >( scriptEvent.code ),
+                scriptEvent.buttons, scriptEvent.modifiers );
+            break;
+        }
+        case QEvent::Wheel:
+        {
+            const QPoint globalPos = w->mapToGlobal( pos );
+
+#if QT_VERSION >= 0x050c00
+            QWheelEvent event( pos, globalPos, QPoint(),
+                QPoint( 0, scriptEvent.delta ), scriptEvent.buttons,
+                scriptEvent.modifiers, Qt::NoScrollPhase, false );
+#elif QT_VERSION >= 0x050000
+            QWheelEvent event( pos, globalPos, QPoint(),
+                QPoint( 0, scriptEvent.delta ), scriptEvent.delta,
+                Qt::Vertical, scriptEvent.buttons, scriptEvent.modifiers );
+#else
+            QWheelEvent event( pos, globalPos, scriptEvent.delta,
+                scriptEvent.buttons, scriptEvent.modifiers, Qt::Vertical );
+#endif
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            QKeyEvent event( scriptEvent.type,
+                scriptEvent.code, scriptEvent.modifiers );
+
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::Enter:
+        {
+            qwtSendEnterEvent( w, pos );
+            break;
+        }
+        default:
+        {
+            QEvent event( scriptEvent.type );
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+    }
+}
+
+static Result qwtRunScript( QwtPicker2* picker, const Script& script )
+{
+    QWidget* canvas = picker->parentWidget();
+
+    // creating the overlays and caches
+    for ( int i = 0; i < script.size(); i++ )
+    {
+        qwtSendEvent( canvas, script[i] );
+        QCoreApplication::processEvents();
+    }
+
+    PaintCounter counter( canvas );
+    qApp->installEventFilter( &counter );
+
+    Result result;
+    result.events = script.size();
+    result.allocations = 0;
+    result.moves = 0;
+    result.movePixels = 0;
+    result.latencies.reserve( script.size() );
+
+    QElapsedTimer timer;
+
+    const int allocations0 = qwtAllocations();
+
+    for ( int i = 0; i < script.size(); i++ )
+    {
+        const qint64 pixels0 = counter.pixels();
+
+        timer.start();
+
+        qwtSendEvent( canvas, script[i] );
+        QCoreApplication::processEvents(); // painting the overlays
+
+        result.latencies += timer.nsecsElapsed();
+
+        if ( script[i].type == QEvent::MouseMove )
+        {
+            result.moves++;
+            result.movePixels += counter.pixels() - pixels0;
+        }
+    }
+
+    // the latencies have been reserved in advance
+    result.allocations = qwtAllocations() - allocations0;
+
+    qApp->removeEventFilter( &counter );
+
+    result.nsecs = 0;
+    for ( int i = 0; i < result.latencies.size(); i++ )
+        result.nsecs += result.latencies[i];
+
+    std::sort( result.latencies.begin(), result.latencies.end() );
+
+    result.paintCount = counter.paintCount();
+    result.paintTime = counter.paintTime();
+
+    return result;
+}
+
+static double qwtPercentile( const QVector< qint64 >& sorted, double p )
+{
+    if ( sorted.isEmpty() )
+        return 0.0;
+
+    const int index = qMin( int( p * sorted.size() ), sorted.size() - 1 );
+    return sorted[index] / 1000.0; // us
+}
+
+static QString qwtField( const QString& text, int width )
+{
+    return QString( "%1" ).arg( text, width );
+}
+
+static QString qwtField( double value, int width, int precision = 1 )
+{
+    return QString( "%1" ).arg( value, width, 'f', precision );
+}
+
+/*
+    Moves in the state, where a selection is active, for the
+    transition API of QwtPicker2Machine, that fills a CommandBuffer.
+ */
+static bool qwtBenchmarkMachines( QTextStream& out )
+{
+    out << "State machines: mouse moves of an active selection\n";
+    out << "Allocations: " << QWT_COUNTED_ALLOCATIONS << "\n\n";
+
+    out << qwtField( "machine", -12 ) << qwtField( "ns/move", 10 )
+        << qwtField( "allocs/move", 13 ) << qwtField( "commands", 10 ) << "\n";
+
+    const int numMoves = 200000;
+    bool ok = true;
+
+    const QwtEventPattern pattern;
+
+    const QwtEventPattern::MousePattern select =
+        pattern.mousePattern()[ QwtEventPattern::MouseSelect2 ];
+
+    const QwtEventPattern::KeyPattern key =
+        pattern.keyPattern()[ QwtEventPattern::KeySelect1 ];
+
+    const QPoint pos( 100, 100 );
+
+    QEvent enterEvent( QEvent::Enter );
+    QMouseEvent pressEvent( QEvent::MouseButtonPress, pos, pos,
+        select.button, select.button, select.modifiers );
+    QKeyEvent keyEvent( QEvent::KeyPress, key.key, key.modifiers );
+    QMouseEvent moveEvent( QEvent::MouseMove, pos, pos,
+        Qt::NoButton, select.button, Qt::NoModifier );
+
+    for ( int i = 0; i < qwtMachineCount; i++ )
+    {
+        QwtPicker2Machine* machine = qwtCreateMachine( i );
+
+        QwtPicker2Machine::CommandBuffer buffer;
+
+        // starting a selection: the polygon machine ends it on a press
+        machine->transition( pattern, &enterEvent, buffer );
+        machine->transition( pattern, &pressEvent, buffer );
+        if ( machine->state() == 0 )
+            machine->transition( pattern, &keyEvent, buffer );
+
+        int numCommands = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        const int allocations0 = qwtAllocations();
+
+        for ( int j = 0; j < numMoves; j++ )
+        {
+            machine->transition( pattern, &moveEvent, buffer );
+            numCommands += buffer.count();
+        }
+
+        const int allocations = qwtAllocations() - allocations0;
+        const qint64 nsecs = timer.nsecsElapsed();
+
+        out << qwtField( qwtMachineName( i ), -12 )
+            << qwtField( double( nsecs ) / numMoves, 10 )
+            << qwtField( double( allocations ) / numMoves, 13, 3 )
+            << qwtField( double( numCommands ) / numMoves, 10 );
+
+        const bool mustNotAllocate = dynamic_cast< QwtPicker2DragRectMachine* >( machine )
+            || dynamic_cast< QwtPicker2PolygonMachine* >( machine );
+
+        if ( mustNotAllocate && allocations > 0 )
+        {
+            out << "  FAILED: allocations";
+            ok = false;
+        }
+
+        out << "\n";
+
+        delete machine;
+    }
+
+    out << "\n";
+    return ok;
+}
+
+/*
+    Mapping points into plot coordinates by QwtPlotPicker2, compared to
+    fetching the scale maps from the plot for each point, what is
+    how QwtPlotPicker2::invTransform() has been implemented before.
+ */
+static void qwtBenchmarkTransformations( QwtPlot* plot, QTextStream& out )
+{
+    out << "Transformations: pixel to plot coordinates\n\n";
+    out << qwtField( "method", -30 ) << qwtField( "Mpoints/s", 12 ) << "\n";
+
+    const QRect rect = plot->canvas()->contentsRect();
+
+    const int numPoints = 1000;
+    const int numLoops = 500;
+
+    QPolygon points( numPoints );
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        points[i] = QPoint( rect.left() + ( i * 7 ) % rect.width(),
+            rect.top() + ( i * 13 ) % rect.height() );
+    }
+
+    PlotPicker picker( plot->canvas() );
+
+    double sum = 0.0;
+    QElapsedTimer timer;
+
+    timer.start();
+    for ( int i = 0; i < numLoops; i++ )
+    {
+        for ( int j = 0; j < numPoints; j++ )
+        {
+            const QwtScaleMap xMap = plot->canvasMap( QwtAxis::XBottom );
+            const QwtScaleMap yMap = plot->canvasMap( QwtAxis::YLeft );
+
+            sum += xMap.invTransform( points[j].x() );
+            sum += yMap.invTransform( points[j].y() );
+        }
+    }
+    const qint64 uncachedNsecs = timer.nsecsElapsed();
+
+    timer.start();
+    for ( int i = 0; i < numLoops; i++ )
+    {
+        for ( int j = 0; j < numPoints; j++ )
+            sum += picker.invTransform( points[j] ).x();
+    }
+    const qint64 pointNsecs = timer.nsecsElapsed();
+
+    timer.start();
+    for ( int i = 0; i < numLoops; i++ )
+        sum += picker.invTransform( points ).last().x();
+    const qint64 polygonNsecs = timer.nsecsElapsed();
+
+    const double numTotal = double( numPoints ) * numLoops;
+
+    out << qwtField( "before: canvasMap() per point", -30 )
+        << qwtField( numTotal / uncachedNsecs * 1000.0, 12, 2 ) << "\n";
+    out << qwtField( "invTransform( QPoint )", -30 )
+        << qwtField( numTotal / pointNsecs * 1000.0, 12, 2 ) << "\n";
+    out << qwtField( "invTransform( QPolygon )", -30 )
+        << qwtField( numTotal / polygonNsecs * 1000.0, 12, 2 ) << "\n";
+
+    out << "\n";
+
+    qwtSink = sum;
+}
+
+/*
+    A line rubber band following the pointer over a 4K canvas. Only
+    the strips of the previous and the current lines need to be painted.
+ */
+static void qwtBenchmarkLineSweep( QTextStream& out )
+{
+    const QSize size( 3840, 2160 );
+
+    out << "Line rubber bands: sweep over a " << size.width()
+        << "x" << size.height() << " canvas\n\n";
+
+    out << qwtField( "rubberband", -12 ) << qwtField( "px/move", 12 )
+        << qwtField( "% of canvas", 13 ) << "\n";
+
+    QWidget canvas;
+    canvas.resize( size );
+    canvas.show();
+
+    QCoreApplication::processEvents();
+
+    const QwtPicker2::RubberBand rubberBands[] =
+    {
+        QwtPicker2::HLineRubberBand,
+        QwtPicker2::VLineRubberBand,
+        QwtPicker2::CrossRubberBand
+    };
+
+    const int numMoves = 1000;
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        QwtPicker2* picker = new QwtPicker2(
+            rubberBands[i], QwtPicker2::AlwaysOff, &canvas );
+        picker->setStateMachine( new QwtPicker2TrackerMachine() );
+        picker->setRubberBandPen( QPen( Qt::red, 2 ) );
+
+        QPoint pos( 10, 10 );
+
+        // the tracker machine begins the selection on entering the canvas
+        qwtSendEnterEvent( &canvas, pos );
+        qwtSendMouseEvent( &canvas, QEvent::MouseMove, pos );
+        QCoreApplication::processEvents();
+
+        PaintCounter counter( &canvas );
+        qApp->installEventFilter( &counter );
+
+        for ( int j = 0; j < numMoves; j++ )
+        {
+            // a diagonal sweep with a few pixels per move
+            pos = QPoint( 10 + ( 3 * j ) % ( size.width() - 20 ),
+                10 + ( 2 * j ) % ( size.height() - 20 ) );
+
+            qwtSendMouseEvent( &canvas, QEvent::MouseMove, pos );
+            QCoreApplication::processEvents();
+        }
+
+        qApp->removeEventFilter( &counter );
+
+        delete picker;
+
+        const double pixels = double( counter.pixels() ) / numMoves;
+
+        out << qwtField( qwtRubberBandName( rubberBands[i] ), -12 )
+            << qwtField( pixels, 12, 0 )
+            << qwtField( 100.0 * pixels / ( size.width() * size.height() ), 13, 3 )
+            << "\n";
+    }
+
+    out << "\n";
+}
+
+static void qwtBenchmarkStreams( QwtPlot* plot, int repeat, QTextStream& out )
+{
+    out << "Event streams: " << plot->canvas()->width() << "x"
+        << plot->canvas()->height() << " canvas\n";
+    out << "Allocations: " << QWT_COUNTED_ALLOCATIONS << "\n\n";
+
+    out << qwtField( "picker", -16 ) << qwtField( "machine", -12 )
+        << qwtField( "rubberband", -12 ) << qwtField( "tracker", -12 )
+        << qwtField( "events/s", 10 ) << qwtField( "p50 us", 9 )
+        << qwtField( "p90 us", 9 ) << qwtField( "p99 us", 9 )
+        << qwtField( "max us", 9 ) << qwtField( "allocs/ev", 11 )
+        << qwtField( "px/move", 10 ) << qwtField( "paint us", 10 ) << "\n";
+
+    QWidget* canvas = plot->canvas();
+
+    const QwtPicker2::DisplayMode trackerModes[] =
+        { QwtPicker2::AlwaysOff, QwtPicker2::ActiveOnly, QwtPicker2::AlwaysOn };
+
+    for ( int plotPicker = 0; plotPicker < 2; plotPicker++ )
+    {
+        for ( int i = 0; i < qwtMachineCount; i++ )
+        {
+            QwtPicker2Machine* machine = qwtCreateMachine( i );
+            const QVector< QwtPicker2::RubberBand > rubberBands =
+                qwtRubberBands( machine->selectionType() );
+            delete machine;
+
+            for ( int j = 0; j < rubberBands.size(); j++ )
+            {
+                for ( int k = 0; k < 3; k++ )
+                {
+                    QwtPicker2* picker;
+                    if ( plotPicker )
+                    {
+                        picker = new QwtPlotPicker2( QwtAxis::XBottom, QwtAxis::YLeft,
+                            rubberBands[j], trackerModes[k], canvas );
+                    }
+                    else
+                    {
+                        picker = new QwtPicker2( rubberBands[j], trackerModes[k], canvas );
+                    }
+
+                    picker->setStateMachine( qwtCreateMachine( i ) );
+                    picker->setRubberBandPen( QPen( Qt::red ) );
+                    picker->setTrackerPen( QPen( Qt::blue ) );
+
+                    const Script script( *picker, canvas->contentsRect(), repeat );
+                    const Result result = qwtRunScript( picker, script );
+
+                    delete picker;
+
+                    const QVector< qint64 >& latencies = result.latencies;
+
+                    out << qwtField( plotPicker ? "QwtPlotPicker2" : "QwtPicker2", -16 )
+                        << qwtField( qwtMachineName( i ), -12 )
+                        << qwtField( qwtRubberBandName( rubberBands[j] ), -12 )
+                        << qwtField( qwtTrackerModeName( trackerModes[k] ), -12 )
+                        << qwtField( result.events * 1e9 / qMax( result.nsecs, qint64( 1 ) ), 10, 0 )
+                        << qwtField( qwtPercentile( latencies, 0.5 ), 9 )
+                        << qwtField( qwtPercentile( latencies, 0.9 ), 9 )
+                        << qwtField( qwtPercentile( latencies, 0.99 ), 9 )
+                        << qwtField( qwtPercentile( latencies, 1.0 ), 9 )
+                        << qwtField( double( result.allocations ) / result.events, 11 )
+                        << qwtField( double( result.movePixels ) / qMax( result.moves, 1 ), 10, 0 );
+
+                    if ( result.paintCount > 0 )
+                        out << qwtField( result.paintTime / 1000.0 / result.paintCount, 10 );
+                    else
+                        out << qwtField( "-", 10 );
+
+                    out << "\n";
+                    out.flush();
+                }
+            }
+        }
+    }
+
+    out << "\n";
+}
+
+static bool qwtParseSize( const QString& text, QSize& size )
+{
+    const QStringList wh = text.split( 'x' );
+    if ( wh.size() != 2 )
+        return false;
+
+    bool okW, okH;
+    const int w = wh[0].toInt( &okW );
+    const int h = wh[1].toInt( &okH );
+
+    if ( !okW || !okH || w <= 0 || h <= 0 )
+        return false;
+
+    size = QSize( w, h );
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+#if QT_VERSION >= 0x050000
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+#endif
+
+    QApplication app( argc, argv );
+
+    QTextStream out( stdout );
+
+    int repeat = 3;
+    QSize size( 1920, 1080 );
+
+    const QStringList args = QCoreApplication::arguments();
+    for ( int i = 1; i < args.size(); i++ )
+    {
+        const bool hasValue = ( i < args.size() - 1 );
+
+        if ( args[i] == "--repeat" && hasValue )
+        {
+            repeat = qMax( args[++i].toInt(), 1 );
+        }
+        else if ( args[i] == "--size" && hasValue
+            && qwtParseSize( args[i + 1], size ) )
+        {
+            i++;
+        }
+        else
+        {
+            out << "Usage: " << args[0]
+                << " [--repeat N] [--size WxH], with N, W, H > 0\n";
+            return 2;
+        }
+    }
+
+    QwtPlot plot;
+    plot.setAutoReplot( false );
+    plot.setAxisScale( QwtAxis::XBottom, 0.0, 1000.0 );
+    plot.setAxisScale( QwtAxis::YLeft, -1.5, 1.5 );
+
+    QVector< QPointF > samples;
+    for ( int i = 0; i < 10000; i++ )
+        samples += QPointF( 0.1 * i, qSin( 0.01 * i ) );
+
+    QwtPlotCurve* curve = new QwtPlotCurve();
+    curve->setSamples( samples );
+    curve->attach( &plot );
+
+    plot.resize( size );
+    plot.show();
+    plot.replot();
+
+    QCoreApplication::processEvents();
+
+    const bool ok = qwtBenchmarkMachines( out );
+    qwtBenchmarkTransformations( &plot, out );
+    qwtBenchmarkLineSweep( out );
+    qwtBenchmarkStreams( &plot, repeat, out );
+
+    out.flush();
+
+    return ok ? 0 : 1;
+}
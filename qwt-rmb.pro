@@ -11,14 +11,23 @@ TEMPLATE = lib
 
 DEFINES += QWTRMB_LIBRARY
 
+# latency statistics of the pickers: QwtPicker2::statistics()
+# DEFINES += QWT_PICKER2_STATISTICS
+
 SOURCES += \
     qwt_picker2.cpp \
     qwt_picker_machine2.cpp \
+    qwt_picker_recorder2.cpp \
+    qwt_picker_statistics2.cpp \
+    qwt_picker_trace2.cpp \
     qwt_plot_picker2.cpp
 
 HEADERS +=\
     qwt_picker2.h \
     qwt_picker_machine2.h \
+    qwt_picker_recorder2.h \
+    qwt_picker_statistics2.h \
+    qwt_picker_trace2.h \
     qwt_plot_picker2.h
 
 unix {
@@ -9,6 +9,8 @@
 
 #include "qwt_picker2.h"
 #include "qwt_picker_machine2.h"
+#include "qwt_picker_statistics2.h"
+#include "qwt_picker_trace2.h"
 #include "qwt_painter.h"
 #include "qwt_math.h"
 #include "qwt_widget_overlay.h"
@@ -17,10 +19,187 @@
 #include <qevent.h>
 #include <qpainter.h>
 #include <qpainterpath.h>
+#include <qpixmap.h>
 #include <qcursor.h>
 #include <qpointer.h>
+#include <qmetaobject.h>
+#include <qbasictimer.h>
+#include <qvector.h>
+#include <qhash.h>
 #include <qmath.h>
 
+// interval for coalescing mouse moves: ~ one frame of a 60Hz display
+static const int qwtFrameInterval = 16;
+
+static inline bool qwtIsLineRubberBand( int rubberBand )
+{
+    return rubberBand == QwtPicker2::HLineRubberBand
+        || rubberBand == QwtPicker2::VLineRubberBand
+        || rubberBand == QwtPicker2::CrossRubberBand;
+}
+
+static inline bool qwtHasPrefix( const QPolygon& points,
+    const QPolygon& prefix, int count )
+{
+    // the first count points of both polygons are the same
+
+    if ( count > points.size() || count > prefix.size() )
+        return false;
+
+    const QPoint* p1 = points.constData();
+    const QPoint* p2 = prefix.constData();
+
+    for ( int i = 0; i < count; i++ )
+    {
+        if ( p1[i] != p2[i] )
+            return false;
+    }
+
+    return true;
+}
+
+static inline bool qwtIsOrderedEvent( QEvent::Type type )
+{
+    // events, that have to be processed after a pending mouse move
+
+    switch ( type )
+    {
+        case QEvent::Resize:
+        case QEvent::Enter:
+        case QEvent::Leave:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        case QEvent::Wheel:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template< class Overlay >
+static inline void qwtDeleteOverlay( QPointer< Overlay >& overlay, bool openGL )
+{
+    if ( overlay.isNull() )
+        return;
+
+    if ( openGL )
+    {
+        // Qt 4.8 crashes for a delete
+        overlay->hide();
+        overlay->deleteLater();
+        overlay = NULL;
+    }
+    else
+    {
+        delete overlay;
+    }
+}
+
+static inline int qwtMachineState( const QwtPicker2Machine* machine )
+{
+    return machine ? machine->state() : -1;
+}
+
+static const char* qwtCommandName( QwtPicker2Machine::Command command )
+{
+    switch ( command )
+    {
+        case QwtPicker2Machine::Begin:
+            return "begin";
+        case QwtPicker2Machine::Append:
+            return "append";
+        case QwtPicker2Machine::Move:
+            return "move";
+        case QwtPicker2Machine::Remove:
+            return "remove";
+        case QwtPicker2Machine::End:
+            return "end";
+    }
+
+    return "command";
+}
+
+static inline quint64 qwtPatternKey( int code, Qt::KeyboardModifiers modifiers )
+{
+    // button or key + modifiers, as being compared by QwtEventPattern
+    return ( quint64( quint32( code ) ) << 32 ) | quint32( int( modifiers ) );
+}
+
+static inline bool qwtKeyMatches( const QwtEventPattern& eventPattern,
+    int patternMask, QwtEventPattern::KeyPatternCode code, const QKeyEvent* event )
+{
+    // patternMask < 0: the event has not been classified
+    if ( patternMask >= 0 )
+        return ( patternMask & ( 1 << code ) ) != 0;
+
+    return eventPattern.keyMatch( code, event );
+}
+
+static inline void qwtUpdatePointerPosition(
+    const QEvent* event, QPoint& pos, bool& isValid, bool& isTracked )
+{
+    /*
+        The last known position of the pointer in widget coordinates.
+        Without mouse tracking mouse moves are delivered only, while
+        a button is pressed. isTracked indicates, that the position is
+        kept up to date - even when mouse tracking is disabled.
+     */
+
+    switch ( event->type() )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            const QMouseEvent* me = static_cast< const QMouseEvent* >( event );
+
+            pos = me->pos();
+            isValid = true;
+            isTracked = me->buttons() != Qt::NoButton;
+            break;
+        }
+        case QEvent::Wheel:
+        {
+            const QWheelEvent* we = static_cast< const QWheelEvent* >( event );
+#if QT_VERSION < 0x050e00
+            pos = we->pos();
+#else
+            pos = we->position().toPoint();
+#endif
+            isValid = true;
+            break;
+        }
+        case QEvent::Enter:
+        {
+#if QT_VERSION >= 0x060000
+            pos = static_cast< const QEnterEvent* >( event )->position().toPoint();
+            isValid = true;
+#elif QT_VERSION >= 0x050000
+            pos = static_cast< const QEnterEvent* >( event )->pos();
+            isValid = true;
+#else
+            isValid = false;
+#endif
+            isTracked = false;
+            break;
+        }
+        case QEvent::Leave:
+        case QEvent::Move:
+        case QEvent::Hide:
+        {
+            isValid = false;
+            isTracked = false;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 static inline QRegion qwtMaskRegion( const QRect& r, int penWidth )
 {
     const int pw = qMax( penWidth, 1 );
@@ -51,18 +230,175 @@ static inline QRegion qwtMaskRegion( const QLine& l, int penWidth )
 
     if ( l.x1() == l.x2() )
     {
-        region += QRect( l.x1() - pw2, l.y1(),
-            pw, l.y2() ).normalized();
+        region += QRect( l.x1() - pw2, qMin( l.y1(), l.y2() ),
+            pw, qAbs( l.y2() - l.y1() ) + 1 );
     }
     else if ( l.y1() == l.y2() )
     {
-        region += QRect( l.x1(), l.y1() - pw2,
-            l.x2(), pw ).normalized();
+        region += QRect( qMin( l.x1(), l.x2() ), l.y1() - pw2,
+            qAbs( l.x2() - l.x1() ) + 1, pw );
+    }
+
+    return region;
+}
+
+static QRegion qwtEllipseMaskRegion( const QRect& rect, int penWidth )
+{
+    /*
+        A ring along the outline of the ellipse, that is drawn into rect.
+        Its width is the pen width + 1 pixel on each side for antialiasing.
+
+        The spans of a scanline are the horizontal extent of the parts
+        of the outline, that are closer than off to the scanline,
+        widened by off on both sides.
+     */
+    const double off = 0.5 * qMax( penWidth, 1 ) + 1.0;
+
+    const QRectF r( rect );
+
+    const double cx = r.center().x();
+    const double cy = r.center().y();
+
+    const double a = 0.5 * r.width();
+    const double b = 0.5 * r.height();
+
+    const int y1 = qFloor( cy - b - off );
+    const int y2 = qCeil( cy + b + off );
+
+    QVector< QRect > rects;
+    rects.reserve( 2 * ( y2 - y1 ) );
+
+    int bandStart = -1; // index of the first rectangle of the last band
+
+    for ( int y = y1; y < y2; y++ )
+    {
+        const double yLo = y - off;
+        const double yHi = y + 1 + off;
+
+        if ( yHi < cy - b || yLo > cy + b )
+            continue;
+
+        // distances of the nearest/farthest part of the outline to cy
+        double dyNear = 0.0;
+        if ( cy < yLo || cy > yHi )
+            dyNear = qMin( qAbs( yLo - cy ), qAbs( yHi - cy ) );
+
+        const double dyFar = qMin( b, qMax( qAbs( yLo - cy ), qAbs( yHi - cy ) ) );
+
+        double wNear = a;
+        double wFar = a;
+        if ( b > 0.0 )
+        {
+            wNear = a * qSqrt( qMax( 0.0, 1.0 - qwtSqr( dyNear / b ) ) );
+            wFar = a * qSqrt( qMax( 0.0, 1.0 - qwtSqr( dyFar / b ) ) );
+        }
+
+        const int left1 = qFloor( cx - wNear - off );
+        const int left2 = qCeil( cx - wFar + off );
+        const int right1 = qFloor( cx + wFar - off );
+        const int right2 = qCeil( cx + wNear + off );
+
+        QRect spans[2];
+        int numSpans = 0;
+
+        if ( left2 < right1 )
+        {
+            spans[numSpans++] = QRect( left1, y, left2 - left1, 1 );
+            spans[numSpans++] = QRect( right1, y, right2 - right1, 1 );
+        }
+        else
+        {
+            spans[numSpans++] = QRect( left1, y, right2 - left1, 1 );
+        }
+
+        // rows with identical spans are merged into one band
+
+        bool merged = false;
+        if ( bandStart >= 0 && rects.size() - bandStart == numSpans
+            && rects[bandStart].bottom() == y - 1 )
+        {
+            merged = true;
+            for ( int i = 0; i < numSpans; i++ )
+            {
+                const QRect& rb = rects[bandStart + i];
+                if ( rb.left() != spans[i].left() || rb.right() != spans[i].right() )
+                {
+                    merged = false;
+                    break;
+                }
+            }
+
+            if ( merged )
+            {
+                for ( int i = 0; i < numSpans; i++ )
+                    rects[bandStart + i].setBottom( y );
+            }
+        }
+
+        if ( !merged )
+        {
+            bandStart = rects.size();
+            for ( int i = 0; i < numSpans; i++ )
+                rects += spans[i];
+        }
     }
 
+    QRegion region;
+    region.setRects( rects.constData(), rects.size() );
+
     return region;
 }
 
+static inline int qwtVertexExtent( const QPen& pen, int penWidth )
+{
+    /*
+        How far the stroke of a polyline might exceed a vertex:
+        square caps of diagonal segments or miter joins
+     */
+    double extent = qMax( penWidth, 1 );
+
+    if ( pen.joinStyle() == Qt::MiterJoin || pen.joinStyle() == Qt::SvgMiterJoin )
+        extent = qMax( extent, 0.5 * extent * pen.miterLimit() );
+
+    return qCeil( extent ) + 1;
+}
+
+static inline QRegion qwtVertexMaskRegion( const QPoint& pos, int extent )
+{
+    return QRegion( pos.x() - extent, pos.y() - extent,
+        2 * extent + 1, 2 * extent + 1 );
+}
+
+static QRegion qwtSegmentMaskRegion(
+    const QPoint& p1, const QPoint& p2, int penWidth )
+{
+    // the stroke of a segment without caps + 1 pixel for antialiasing
+
+    if ( p1.x() == p2.x() || p1.y() == p2.y() )
+    {
+        const int off = qMax( penWidth, 1 ) / 2 + 1;
+
+        const QRect r = QRect( p1, p2 ).normalized();
+        return QRegion( r.adjusted( -off, -off, off, off ) );
+    }
+
+    const double off = 0.5 * qMax( penWidth, 1 ) + 1.5;
+
+    const double dx = p2.x() - p1.x();
+    const double dy = p2.y() - p1.y();
+    const double len = qSqrt( dx * dx + dy * dy );
+
+    const QPointF n( -dy / len * off, dx / len * off );
+
+    QPolygonF quad( 4 );
+    quad[0] = QPointF( p1 ) + n;
+    quad[1] = QPointF( p2 ) + n;
+    quad[2] = QPointF( p2 ) - n;
+    quad[3] = QPointF( p1 ) - n;
+
+    return QRegion( quad.toPolygon(), Qt::WindingFill );
+}
+
 namespace
 {
     class Rubberband QWT_FINAL : public QwtWidgetOverlay
@@ -78,12 +414,16 @@ namespace
       protected:
         virtual void drawOverlay( QPainter* painter ) const QWT_OVERRIDE
         {
+            QWT_PICKER2_SAMPLE( m_picker->statistics(), OverlayPaint );
+            QwtPicker2Trace::Scope scope( m_picker->trace(), "paintRubberBand", m_picker );
+
             painter->setPen( m_picker->rubberBandPen() );
             m_picker->drawRubberBand( painter );
         }
 
         virtual QRegion maskHint() const QWT_OVERRIDE
         {
+            QWT_PICKER2_SAMPLE( m_picker->statistics(), RubberBandMask );
             return m_picker->rubberBandMask();
         }
 
@@ -103,17 +443,441 @@ namespace
       protected:
         virtual void drawOverlay( QPainter* painter ) const QWT_OVERRIDE
         {
+            QWT_PICKER2_SAMPLE( m_picker->statistics(), OverlayPaint );
+            QwtPicker2Trace::Scope scope( m_picker->trace(), "paintTracker", m_picker );
+
             painter->setPen( m_picker->trackerPen() );
             m_picker->drawTracker( painter );
         }
 
         virtual QRegion maskHint() const QWT_OVERRIDE
         {
+            QWT_PICKER2_SAMPLE( m_picker->statistics(), TrackerMask );
             return m_picker->trackerMask();
         }
 
         QwtPicker2* m_picker;
     };
+
+    /*
+        An overlay shared by all pickers of a widget, that have
+        enabled QwtPicker2::sharedOverlay(). The rubber bands and
+        trackers of all pickers are painted in one pass.
+     */
+    class SharedOverlay QWT_FINAL : public QwtWidgetOverlay
+    {
+      public:
+        static SharedOverlay* find( const QWidget* widget )
+        {
+            const QObjectList children = widget->children();
+            for ( int i = 0; i < children.size(); i++ )
+            {
+                QObject* child = children[i];
+
+                // the slots are NULL, while the children are deleted
+                if ( child && child->isWidgetType() &&
+                    child->objectName() == QLatin1String( name() ) )
+                {
+                    return static_cast< SharedOverlay* >( child );
+                }
+            }
+
+            return NULL;
+        }
+
+        SharedOverlay()
+            : QwtWidgetOverlay( NULL ) // NULL -> no extra event filter
+        {
+            setObjectName( QLatin1String( name() ) );
+            setMaskMode( QwtWidgetOverlay::MaskHint );
+        }
+
+        void setDisplay( QwtPicker2* picker, bool showRubberBand, bool showTracker )
+        {
+            int index = indexOf( picker );
+            if ( index < 0 )
+            {
+                if ( !( showRubberBand || showTracker ) )
+                    return;
+
+                Entry entry;
+                entry.picker = picker;
+                entry.rubberBand = entry.tracker = false;
+
+                m_entries += entry;
+                index = m_entries.size() - 1;
+            }
+
+            Entry& entry = m_entries[index];
+
+            if ( entry.rubberBand || entry.tracker || showRubberBand || showTracker )
+            {
+                // updates of several pickers are done in one pass
+                if ( !m_timer.isActive() )
+                    m_timer.start( 0, this );
+            }
+
+            entry.rubberBand = showRubberBand;
+            entry.tracker = showTracker;
+        }
+
+        void removePicker( const QwtPicker2* picker )
+        {
+            const int index = indexOf( picker );
+            if ( index >= 0 )
+            {
+                m_entries.removeAt( index );
+
+                if ( !m_timer.isActive() )
+                    m_timer.start( 0, this );
+            }
+
+            if ( m_entries.isEmpty() )
+            {
+                // not to be found anymore, while being deleted
+                setObjectName( QString() );
+
+                hide();
+                deleteLater();
+            }
+        }
+
+        bool isRetired() const
+        {
+            // the deletion has been scheduled by removePicker()
+            return objectName().isEmpty();
+        }
+
+      protected:
+        virtual void drawOverlay( QPainter* painter ) const QWT_OVERRIDE
+        {
+            for ( int i = 0; i < m_entries.size(); i++ )
+            {
+                const Entry& entry = m_entries[i];
+                if ( entry.picker.isNull() )
+                    continue;
+
+                QWT_PICKER2_SAMPLE( entry.picker->statistics(), OverlayPaint );
+                QwtPicker2Trace::Scope scope( entry.picker->trace(),
+                    "paintSharedOverlay", entry.picker.data() );
+
+                if ( entry.rubberBand )
+                {
+                    painter->save();
+                    painter->setPen( entry.picker->rubberBandPen() );
+                    entry.picker->drawRubberBand( painter );
+                    painter->restore();
+                }
+
+                if ( entry.tracker )
+                {
+                    painter->save();
+                    painter->setPen( entry.picker->trackerPen() );
+                    painter->setFont( entry.picker->trackerFont() );
+                    entry.picker->drawTracker( painter );
+                    painter->restore();
+                }
+            }
+        }
+
+        virtual QRegion maskHint() const QWT_OVERRIDE
+        {
+            QRegion mask;
+
+            for ( int i = 0; i < m_entries.size(); i++ )
+            {
+                const Entry& entry = m_entries[i];
+                if ( entry.picker.isNull() )
+                    continue;
+
+                if ( entry.rubberBand )
+                {
+                    QWT_PICKER2_SAMPLE( entry.picker->statistics(), RubberBandMask );
+                    mask += entry.picker->rubberBandMask();
+                }
+
+                if ( entry.tracker )
+                {
+                    QWT_PICKER2_SAMPLE( entry.picker->statistics(), TrackerMask );
+                    mask += entry.picker->trackerMask();
+                }
+            }
+
+            return mask;
+        }
+
+        virtual void timerEvent( QTimerEvent* event ) QWT_OVERRIDE
+        {
+            if ( event->timerId() != m_timer.timerId() )
+            {
+                QwtWidgetOverlay::timerEvent( event );
+                return;
+            }
+
+            m_timer.stop();
+
+            bool doShow = false;
+            bool hasMask = true;
+
+            for ( int i = 0; i < m_entries.size(); i++ )
+            {
+                const Entry& entry = m_entries[i];
+                if ( entry.picker.isNull() )
+                    continue;
+
+                if ( entry.rubberBand || entry.tracker )
+                    doShow = true;
+
+                // user defined rubber bands might not have a mask
+                if ( entry.rubberBand &&
+                    entry.picker->rubberBand() > QwtPicker2::PolygonRubberBand )
+                {
+                    hasMask = false;
+                }
+            }
+
+            if ( doShow )
+            {
+                setMaskMode( hasMask ? QwtWidgetOverlay::MaskHint
+                    : QwtWidgetOverlay::AlphaMask );
+
+                updateOverlay();
+            }
+            else
+            {
+                hide();
+            }
+        }
+
+      private:
+        static const char* name()
+        {
+            return "PickerSharedOverlay";
+        }
+
+        int indexOf( const QwtPicker2* picker ) const
+        {
+            for ( int i = 0; i < m_entries.size(); i++ )
+            {
+                if ( m_entries[i].picker.data() == picker )
+                    return i;
+            }
+
+            return -1;
+        }
+
+        class Entry
+        {
+          public:
+            QPointer< QwtPicker2 > picker;
+            bool rubberBand;
+            bool tracker;
+        };
+
+        QList< Entry > m_entries;
+        QBasicTimer m_timer;
+    };
+
+    /*
+        An event filter, that is shared by all pickers of a widget,
+        that have enabled QwtPicker2::sharedEventFilter(). For pickers
+        with QwtPicker2::prefilterEvents() events are passed only,
+        when they might be processed.
+     */
+    class EventDispatcher QWT_FINAL : public QObject
+    {
+      public:
+        static EventDispatcher* find( const QWidget* widget )
+        {
+            const QObjectList children = widget->children();
+            for ( int i = 0; i < children.size(); i++ )
+            {
+                QObject* child = children[i];
+
+                // the slots are NULL, while the children are deleted
+                if ( child && !child->isWidgetType() &&
+                    child->objectName() == QLatin1String( name() ) )
+                {
+                    return static_cast< EventDispatcher* >( child );
+                }
+            }
+
+            return NULL;
+        }
+
+        explicit EventDispatcher( QWidget* widget )
+            : QObject( widget )
+            , m_hasPointerPosition( false )
+            , m_isPointerTracked( false )
+        {
+            setObjectName( QLatin1String( name() ) );
+            widget->installEventFilter( this );
+        }
+
+        void addPicker( QwtPicker2* picker )
+        {
+            if ( indexOf( picker ) < 0 )
+                m_pickers += picker;
+        }
+
+        void removePicker( const QwtPicker2* picker )
+        {
+            const int index = indexOf( picker );
+            if ( index >= 0 )
+                m_pickers.removeAt( index );
+
+            if ( m_pickers.isEmpty() )
+            {
+                // not to be found anymore, while being deleted
+                setObjectName( QString() );
+
+                parent()->removeEventFilter( this );
+                deleteLater();
+            }
+        }
+
+        bool isRetired() const
+        {
+            // the deletion has been scheduled by removePicker()
+            return objectName().isEmpty();
+        }
+
+        virtual bool eventFilter( QObject* object, QEvent* event ) QWT_OVERRIDE
+        {
+            if ( object != parent() )
+                return false;
+
+            qwtUpdatePointerPosition( event, m_pointerPosition,
+                m_hasPointerPosition, m_isPointerTracked );
+
+            /*
+                The pickers might be removed, while processing the event.
+                Like for event filters of their own, the picker, that has
+                been added last, gets the event first.
+             */
+            const QList< QPointer< QwtPicker2 > > pickers = m_pickers;
+
+            for ( int i = pickers.size() - 1; i >= 0; i-- )
+            {
+                QwtPicker2* picker = pickers[i];
+
+                if ( picker && isObserving( picker, event->type() ) )
+                {
+                    if ( picker->eventFilter( object, event ) )
+                        return true;
+                }
+            }
+
+            return false;
+        }
+
+        void setPointerPosition( const QPoint& pos )
+        {
+            m_pointerPosition = pos;
+            m_hasPointerPosition = true;
+            m_isPointerTracked = true;
+        }
+
+        bool pointerPosition( QPoint& pos, bool& isTracked ) const
+        {
+            if ( m_hasPointerPosition )
+            {
+                pos = m_pointerPosition;
+                isTracked = m_isPointerTracked;
+            }
+
+            return m_hasPointerPosition;
+        }
+
+      private:
+        static const char* name()
+        {
+            return "PickerEventDispatcher";
+        }
+
+        static bool isObserving( const QwtPicker2* picker, QEvent::Type type )
+        {
+            if ( !picker->prefilterEvents() )
+                return true;
+
+            switch ( type )
+            {
+                case QEvent::MouseButtonPress:
+                case QEvent::MouseButtonRelease:
+                case QEvent::MouseButtonDblClick:
+                case QEvent::KeyRelease:
+                {
+                    // these events are passed to the state machine only
+                    const QwtPicker2Machine* machine = picker->stateMachine();
+                    return machine && machine->acceptsEvent( type );
+                }
+                case QEvent::MouseMove:
+                {
+                    // mouse moves also update the tracker
+                    if ( picker->isActive() ||
+                        picker->trackerMode() == QwtPicker2::AlwaysOn )
+                    {
+                        return true;
+                    }
+
+                    const QwtPicker2Machine* machine = picker->stateMachine();
+                    return machine && machine->acceptsEvent( type );
+                }
+                default:
+                    return true;
+            }
+        }
+
+        int indexOf( const QwtPicker2* picker ) const
+        {
+            for ( int i = 0; i < m_pickers.size(); i++ )
+            {
+                if ( m_pickers[i].data() == picker )
+                    return i;
+            }
+
+            return -1;
+        }
+
+        QList< QPointer< QwtPicker2 > > m_pickers;
+
+        // shared by all pickers: not all of them receive the mouse moves
+        QPoint m_pointerPosition;
+        bool m_hasPointerPosition;
+        bool m_isPointerTracked;
+    };
+}
+
+static void qwtObserveWidget( QwtPicker2* picker, QWidget* widget,
+    bool sharedEventFilter, bool on, QPointer< EventDispatcher >& dispatcher )
+{
+    if ( !sharedEventFilter )
+    {
+        if ( on )
+            widget->installEventFilter( picker );
+        else
+            widget->removeEventFilter( picker );
+
+        return;
+    }
+
+    if ( on )
+    {
+        if ( dispatcher.isNull() || dispatcher->isRetired() )
+            dispatcher = EventDispatcher::find( widget );
+
+        if ( dispatcher.isNull() )
+            dispatcher = new EventDispatcher( widget );
+
+        dispatcher->addPicker( picker );
+    }
+    else
+    {
+        if ( dispatcher )
+            dispatcher->removePicker( picker );
+
+        dispatcher = NULL;
+    }
 }
 
 class QwtPicker2::PrivateData
@@ -125,10 +889,35 @@ class QwtPicker2::PrivateData
         resizeMode( QwtPicker2::Stretch ),
         rubberBand( QwtPicker2::NoRubberBand ),
         trackerMode( QwtPicker2::AlwaysOff ),
+        xScale( 1.0 ),
+        yScale( 1.0 ),
+        pickedPointsValid( true ),
         isActive( false ),
         trackerPosition( -1, -1 ),
         mouseTracking( false ),
-        openGL( false )
+        openGL( false ),
+        persistentOverlays( false ),
+        sharedOverlay( false ),
+        sharedEventFilter( false ),
+        prefilterEvents( false ),
+        hasPointerPosition( false ),
+        isPointerTracked( false ),
+        changedDelay( 0 ),
+        signalDelivery( QwtPicker2::ImmediateDelivery ),
+        signalInterval( qwtFrameInterval ),
+        patternTables( false ),
+        patternTablesValid( false ),
+        moveCoalescing( false ),
+        hasPendingMove( false ),
+        trackerTextValid( false ),
+        trackerSizeValid( false ),
+        pickAreaValid( false ),
+        pickAreaIsRect( false ),
+        polygonMaskCount( 0 ),
+        polygonMaskPenWidth( -1 ),
+        polygonMaskExtent( -1 ),
+        polygonMaskTailCount( -1 ),
+        polylineCount( 0 )
     {
     }
 
@@ -145,7 +934,19 @@ class QwtPicker2::PrivateData
     QPen trackerPen;
     QFont trackerFont;
 
+    /*
+        The picked points are stored without rounding in coordinates,
+        that are mapped to the widget by a scale factor. Resizing the
+        widget only changes the factor and pickedPoints() - the points
+        mapped to integer widget coordinates - are rebuilt on demand.
+     */
+    QPolygonF points;
+    double xScale;
+    double yScale;
+    QSize stretchSize; // last size of the widget, that was not empty
+
     QPolygon pickedPoints;
+    bool pickedPointsValid;
     bool isActive;
     QPoint trackerPosition;
 
@@ -154,7 +955,104 @@ class QwtPicker2::PrivateData
     QPointer< Rubberband > rubberBandOverlay;
     QPointer< Tracker > trackerOverlay;
 
+    // not looked up in the destructor: the parent might be in destruction
+    QPointer< SharedOverlay > sharedOverlayWidget;
+    QPointer< EventDispatcher > eventDispatcher;
+
+    QPointer< QwtPicker2Trace > trace;
+
     bool openGL;
+    bool persistentOverlays;
+    bool sharedOverlay;
+    bool sharedEventFilter;
+    bool prefilterEvents;
+
+    // last known position of the pointer, to avoid QCursor::pos()
+    bool hasPointerPosition;
+    bool isPointerTracked;
+    QPoint pointerPosition;
+
+    int changedDelay;
+    QBasicTimer changedTimer;
+
+    // positions of moves, that have not been delivered yet
+    QwtPicker2::SignalDelivery signalDelivery;
+    int signalInterval;
+    QBasicTimer signalTimer;
+    QPolygon movedPositions;
+
+    /*
+        mousePattern()/keyPattern() compiled into tables mapping
+        button/key + modifiers to a bitmask of the matching codes.
+        The shared copies of the patterns detach, when the patterns
+        are modified: comparing the data pointers detects modifications.
+     */
+    bool patternTables;
+    bool patternTablesValid;
+    QHash< quint64, int > mousePatternMasks;
+    QHash< quint64, int > keyPatternMasks;
+    QVector< QwtEventPattern::MousePattern > mousePatterns;
+    QVector< QwtEventPattern::KeyPattern > keyPatterns;
+
+    bool moveCoalescing;
+    bool hasPendingMove;
+    QBasicTimer moveTimer;
+
+    QPoint pendingPos;
+    QPoint pendingGlobalPos;
+    Qt::MouseButtons pendingButtons;
+    Qt::KeyboardModifiers pendingModifiers;
+
+    // trackerText() and its size for trackerTextPosition
+    bool trackerTextValid;
+    QPoint trackerTextPosition;
+    QwtText trackerText;
+
+    bool trackerSizeValid;
+    QFont trackerSizeFont;
+    QSizeF trackerSize;
+
+    /*
+        pickArea() and its bounding rectangle. Geometry of the
+        observed widget, that has been used, as resize events
+        are not received, when the picker is disabled.
+     */
+    bool pickAreaValid;
+    bool pickAreaIsRect;
+    QPainterPath pickArea;
+    QRect pickRect;
+    QSize pickAreaWidgetSize;
+    QRect pickAreaContentsRect;
+
+    // area of the rubber band, that has been painted last
+    QRegion rubberBandRegion;
+
+    /*
+        stroked mask of a polygon rubber band: only the last point
+        is moving, the segments between the other points are cached
+     */
+    int polygonMaskCount; // points in polygonMask, -1 when invalidated
+    QPolygon polygonMaskPoints;
+    int polygonMaskPenWidth;
+    int polygonMaskExtent;
+    QRegion polygonMask;
+
+    // segment to the last point, for polygonMaskTailCount points
+    int polygonMaskTailCount;
+    QPoint polygonMaskTailPos;
+    QRegion polygonMaskTail;
+
+    QRegion polygonMaskChanged; // since the last updateDisplay()
+
+    // segments of a polygon rubber band, that have been drawn already
+    QPixmap polylinePixmap;
+    QPen polylinePen;
+    int polylineCount;
+    QPolygon polylinePoints;
+
+#ifdef QWT_PICKER2_STATISTICS
+    QwtPicker2Statistics statistics;
+#endif
 };
 
 /*!
@@ -191,6 +1089,12 @@ QwtPicker2::~QwtPicker2()
 {
     setMouseTracking( false );
 
+    if ( m_data->sharedOverlayWidget )
+        m_data->sharedOverlayWidget->removePicker( this );
+
+    if ( m_data->eventDispatcher )
+        m_data->eventDispatcher->removePicker( this );
+
     delete m_data->stateMachine;
     delete m_data->rubberBandOverlay;
     delete m_data->trackerOverlay;
@@ -289,7 +1193,11 @@ const QWidget* QwtPicker2::parentWidget() const
  */
 void QwtPicker2::setRubberBand( RubberBand rubberBand )
 {
-    m_data->rubberBand = rubberBand;
+    if ( m_data->rubberBand != rubberBand )
+    {
+        m_data->rubberBand = rubberBand;
+        invalidateTrackerText();
+    }
 }
 
 /*!
@@ -364,6 +1272,280 @@ QwtPicker2::ResizeMode QwtPicker2::resizeMode() const
     return m_data->resizeMode;
 }
 
+/*!
+   \brief En/disable coalescing of mouse move events
+
+   Pointing devices with high report rates generate much more mouse
+   move events than can be displayed. When coalescing is enabled
+   a mouse move is processed immediately, but all further moves
+   within the same display frame are buffered and only the last
+   position is passed to widgetMouseMoveEvent() at the end of the frame.
+
+   Any other event ( mouse buttons, keys, wheel, enter/leave, resize )
+   flushes a buffered move before it is processed, so that
+   the order of the commands of the state machine is preserved.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa moveCoalescing(), widgetMouseMoveEvent()
+ */
+void QwtPicker2::setMoveCoalescing( bool on )
+{
+    if ( m_data->moveCoalescing != on )
+    {
+        if ( !on )
+        {
+            flushMouseMove();
+            m_data->moveTimer.stop();
+        }
+
+        m_data->moveCoalescing = on;
+    }
+}
+
+/*!
+   \return True, when mouse moves are coalesced
+   \sa setMoveCoalescing()
+ */
+bool QwtPicker2::moveCoalescing() const
+{
+    return m_data->moveCoalescing;
+}
+
+/*!
+   \brief En/disable tables for classifying mouse and key events
+
+   Usually the state machine matches an event against the patterns
+   of its transitions by calling QwtEventPattern::mouseMatch() or
+   QwtEventPattern::keyMatch() for each of them. With pattern tables
+   enabled, mousePattern() and keyPattern() are compiled into tables,
+   so that an event is classified by one lookup in mousePatternMask()
+   or keyPatternMask().
+
+   The tables are rebuilt, when setMousePattern() or setKeyPattern()
+   have been called. For other modifications, that can't be detected,
+   invalidatePatternTables() has to be called.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa patternTables(), invalidatePatternTables()
+
+   \warning Pickers reimplementing the pattern based mouseMatch() or
+            keyMatch() are not supported, unless mousePatternMask() and
+            keyPatternMask() are reimplemented accordingly.
+ */
+void QwtPicker2::setPatternTables( bool on )
+{
+    if ( m_data->patternTables != on )
+    {
+        m_data->patternTables = on;
+        invalidatePatternTables();
+    }
+}
+
+/*!
+   \return True, when the patterns are compiled into tables
+   \sa setPatternTables()
+ */
+bool QwtPicker2::patternTables() const
+{
+    return m_data->patternTables;
+}
+
+/*!
+   \brief Rebuild the pattern tables, before they are used next time
+
+   Modifications by setMousePattern() or setKeyPattern() are detected
+   automatically. invalidatePatternTables() is only necessary, when
+   patterns are modified in a way, that bypasses them.
+
+   \sa setPatternTables()
+ */
+void QwtPicker2::invalidatePatternTables()
+{
+    m_data->patternTablesValid = false;
+    m_data->mousePatternMasks.clear();
+    m_data->keyPatternMasks.clear();
+    m_data->mousePatterns.clear();
+    m_data->keyPatterns.clear();
+}
+
+/*!
+   \brief En/disable persistent overlays
+
+   By default the overlays for the rubber band and the tracker are
+   deleted, when they are not displayed anymore and created again,
+   when they are needed. For pickers, that are activated frequently
+   - f.e. with a tracker, that is displayed for ActiveOnly - this
+   results in creating and destroying widgets for each selection.
+
+   When persistent overlays are enabled, the overlays are hidden and
+   reused instead. The memory of hidden overlays can be released
+   explicitly by releaseOverlays().
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa persistentOverlays(), releaseOverlays()
+ */
+void QwtPicker2::setPersistentOverlays( bool on )
+{
+    if ( m_data->persistentOverlays != on )
+    {
+        m_data->persistentOverlays = on;
+
+        if ( !on )
+            releaseOverlays();
+    }
+}
+
+/*!
+   \return True, when hidden overlays are kept for being reused
+   \sa setPersistentOverlays()
+ */
+bool QwtPicker2::persistentOverlays() const
+{
+    return m_data->persistentOverlays;
+}
+
+/*!
+   \brief Delete the overlays, that are not displayed
+
+   Pickers with persistentOverlays() keep their overlays even when
+   they are idle. For applications with many pickers this method
+   releases the memory of the hidden overlays. They will be
+   created again, when they are needed.
+
+   \sa setPersistentOverlays()
+ */
+void QwtPicker2::releaseOverlays()
+{
+    if ( m_data->rubberBandOverlay && m_data->rubberBandOverlay->isHidden() )
+        qwtDeleteOverlay( m_data->rubberBandOverlay, m_data->openGL );
+
+    if ( m_data->trackerOverlay && m_data->trackerOverlay->isHidden() )
+        qwtDeleteOverlay( m_data->trackerOverlay, m_data->openGL );
+}
+
+/*!
+   \brief En/disable an overlay, that is shared with other pickers
+
+   By default each picker creates its own overlays for the rubber band
+   and the tracker. When several pickers are attached to the same
+   widget each of them is composited and masked separately.
+
+   Pickers with a shared overlay display their rubber bands and
+   trackers in one overlay of the parent widget, that is painted
+   in one pass with the union of the masks of all pickers.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa sharedOverlay(), rubberBandMask(), trackerMask()
+ */
+void QwtPicker2::setSharedOverlay( bool on )
+{
+    if ( m_data->sharedOverlay == on )
+        return;
+
+    if ( !on && m_data->sharedOverlayWidget )
+    {
+        m_data->sharedOverlayWidget->removePicker( this );
+        m_data->sharedOverlayWidget = NULL;
+    }
+
+    m_data->sharedOverlay = on;
+    updateDisplay();
+}
+
+/*!
+   \return True, when the overlay is shared with other pickers
+   \sa setSharedOverlay()
+ */
+bool QwtPicker2::sharedOverlay() const
+{
+    return m_data->sharedOverlay;
+}
+
+/*!
+   \brief En/disable an event filter, that is shared with other pickers
+
+   By default each picker installs its own event filter for
+   the parentWidget(), so that each event is processed by all
+   pickers of the widget.
+
+   Pickers with a shared event filter are served by one event filter
+   of the widget, that passes the events to them in the same order
+   as individual event filters would do. Together with prefilterEvents()
+   the events are passed only to the pickers, that might process them.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa sharedEventFilter(), setPrefilterEvents()
+ */
+void QwtPicker2::setSharedEventFilter( bool on )
+{
+    if ( m_data->sharedEventFilter == on )
+        return;
+
+    QWidget* w = parentWidget();
+    if ( w && m_data->enabled )
+    {
+        qwtObserveWidget( this, w, m_data->sharedEventFilter,
+            false, m_data->eventDispatcher );
+        qwtObserveWidget( this, w, on, true, m_data->eventDispatcher );
+    }
+
+    m_data->sharedEventFilter = on;
+}
+
+/*!
+   \return True, when the event filter is shared with other pickers
+   \sa setSharedEventFilter()
+ */
+bool QwtPicker2::sharedEventFilter() const
+{
+    return m_data->sharedEventFilter;
+}
+
+/*!
+   \brief En/disable filtering the events by the state machine
+
+   When prefiltering is enabled, the shared event filter passes
+   an event only, when it might be processed: f.e. mouse moves are
+   not passed to an idle picker, whose state machine ignores them
+   and that doesn't display a tracker.
+
+   \note Overloaded event handlers - like widgetMousePressEvent() - and
+         reimplementations of eventFilter() are not called for events,
+         that are ignored by the state machine. So prefiltering should
+         only be enabled, when the picker doesn't process other events.
+
+   Prefiltering has no effect without sharedEventFilter().
+   The default setting is false.
+
+   \param on On/Off
+   \sa prefilterEvents(), setSharedEventFilter(),
+       QwtPicker2Machine::acceptsEvent()
+ */
+void QwtPicker2::setPrefilterEvents( bool on )
+{
+    m_data->prefilterEvents = on;
+}
+
+/*!
+   \return True, when the shared event filter passes only events,
+           that might be processed by the state machine
+   \sa setPrefilterEvents()
+ */
+bool QwtPicker2::prefilterEvents() const
+{
+    return m_data->prefilterEvents;
+}
+
 /*!
    \brief En/disable the picker
 
@@ -379,13 +1561,25 @@ void QwtPicker2::setEnabled( bool enabled )
     {
         m_data->enabled = enabled;
 
+        if ( !enabled )
+        {
+            m_data->hasPendingMove = false;
+            m_data->moveTimer.stop();
+
+            m_data->hasPointerPosition = false;
+            m_data->isPointerTracked = false;
+        }
+        else
+        {
+            // events, that change a reimplemented pickArea(), have been missed
+            invalidatePickArea();
+        }
+
         QWidget* w = parentWidget();
         if ( w )
         {
-            if ( enabled )
-                w->installEventFilter( this );
-            else
-                w->removeEventFilter( this );
+            qwtObserveWidget( this, w, m_data->sharedEventFilter,
+                enabled, m_data->eventDispatcher );
         }
 
         updateDisplay();
@@ -413,6 +1607,8 @@ void QwtPicker2::setTrackerFont( const QFont& font )
     if ( font != m_data->trackerFont )
     {
         m_data->trackerFont = font;
+        m_data->trackerSizeValid = false;
+
         updateDisplay();
     }
 }
@@ -484,6 +1680,13 @@ QPen QwtPicker2::rubberBandPen() const
 
    The format for the string conversion is "%d".
 
+   \note The text is calculated once for each update of the display
+         and reused for the tracker mask and painting, as long as the
+         position doesn't change. Reimplementations depending on other
+         parameters don't need to care, unless they change between
+         updateDisplay() and painting: then invalidateTrackerText()
+         has to be called.
+
    \param pos Position
    \return Converted position as string
  */
@@ -533,7 +1736,11 @@ QRegion QwtPicker2::rubberBandMask() const
         return mask;
     }
 
-    const QPolygon pa = adjustedPoints( m_data->pickedPoints );
+    QPolygon pa;
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, AdjustedPoints );
+        pa = adjustedPoints( pickedPoints() );
+    }
 
     QwtPicker2Machine::SelectionType selectionType =
         QwtPicker2Machine::NoSelection;
@@ -554,7 +1761,7 @@ QRegion QwtPicker2::rubberBandMask() const
 
             const QPoint pos = pa[0];
 
-            const QRect pRect = pickArea().boundingRect().toRect();
+            const QRect pRect = pickRect();
             switch ( rubberBand() )
             {
                 case VLineRubberBand:
@@ -598,7 +1805,7 @@ QRegion QwtPicker2::rubberBandMask() const
                 case EllipseRubberBand:
                 {
                     const QRect r = QRect( pa.first(), pa.last() );
-                    mask += r.adjusted( -pw, -pw, pw, pw );
+                    mask = qwtEllipseMaskRegion( r.normalized(), pw );
                     break;
                 }
                 default:
@@ -608,15 +1815,8 @@ QRegion QwtPicker2::rubberBandMask() const
         }
         case QwtPicker2Machine::PolygonSelection:
         {
-            if ( pw <= 1 )
-            {
-                // because of the join style we better
-                // return a mask for a pen width <= 1 only
-
-                const int off = 2 * pw;
-                const QRect r = pa.boundingRect();
-                mask += r.adjusted( -off, -off, off, off );
-            }
+            if ( rubberBand() == PolygonRubberBand )
+                mask = polygonMask( pa, pw );
             break;
         }
         default:
@@ -626,6 +1826,103 @@ QRegion QwtPicker2::rubberBandMask() const
     return mask;
 }
 
+/*!
+   \brief Stroked mask of a polygon rubber band
+
+   \param points Adjusted points of the selection
+   \param penWidth Pen width in device pixels
+   \return Mask of the polyline
+   \sa updatePolygonMask()
+ */
+QRegion QwtPicker2::polygonMask( const QPolygon& points, int penWidth ) const
+{
+    updatePolygonMask( points, penWidth );
+    return m_data->polygonMask + m_data->polygonMaskTail;
+}
+
+/*!
+   \brief Update the cached mask of a polygon rubber band
+
+   The segments between all points but the last one are cached
+   and only the segments, that have been appended or moved, are added.
+   The area, that has been changed, is collected in polygonMaskChanged.
+
+   The cache is validated by comparing the cached points with the
+   corresponding points of the selection, so that reimplementations of
+   adjustedPoints() are free to move any of the points.
+
+   \param points Adjusted points of the selection
+   \param penWidth Pen width in device pixels
+ */
+void QwtPicker2::updatePolygonMask( const QPolygon& points, int penWidth ) const
+{
+    PrivateData* d = m_data;
+
+    const int extent = qwtVertexExtent( rubberBandPen(), penWidth );
+    const int numStable = points.count() - 1;
+    const int count = d->polygonMaskCount;
+
+    const bool isValid = ( count >= 0 ) && ( count <= numStable )
+        && ( penWidth == d->polygonMaskPenWidth )
+        && ( extent == d->polygonMaskExtent )
+        && qwtHasPrefix( points, d->polygonMaskPoints, count );
+
+    if ( !isValid )
+    {
+        // the area of the previous polyline has to be repainted
+        d->polygonMaskChanged += d->polygonMask;
+        d->polygonMaskChanged += d->polygonMaskTail;
+
+        d->polygonMaskCount = 0;
+        d->polygonMask = QRegion();
+        d->polygonMaskTail = QRegion();
+        d->polygonMaskTailCount = -1;
+        d->polygonMaskPenWidth = penWidth;
+        d->polygonMaskExtent = extent;
+    }
+    else if ( d->polygonMaskTailCount == points.count()
+        && ( numStable < 0 || points[numStable] == d->polygonMaskTailPos ) )
+    {
+        // nothing has changed
+        return;
+    }
+
+    d->polygonMaskChanged += d->polygonMaskTail;
+
+    for ( int i = d->polygonMaskCount; i < numStable; i++ )
+    {
+        QRegion r = qwtVertexMaskRegion( points[i], extent );
+        if ( i > 0 )
+            r += qwtSegmentMaskRegion( points[i - 1], points[i], penWidth );
+
+        d->polygonMask += r;
+        d->polygonMaskChanged += r;
+    }
+
+    if ( numStable > d->polygonMaskCount )
+    {
+        d->polygonMaskCount = numStable;
+        d->polygonMaskPoints = points.mid( 0, numStable );
+    }
+
+    QRegion tail;
+    if ( numStable >= 0 )
+    {
+        tail = qwtVertexMaskRegion( points[numStable], extent );
+        if ( numStable > 0 )
+        {
+            tail += qwtSegmentMaskRegion(
+                points[numStable - 1], points[numStable], penWidth );
+        }
+
+        d->polygonMaskTailPos = points[numStable];
+    }
+
+    d->polygonMaskTail = tail;
+    d->polygonMaskTailCount = points.count();
+    d->polygonMaskChanged += tail;
+}
+
 /*!
    Draw a rubber band, depending on rubberBand()
 
@@ -642,7 +1939,11 @@ void QwtPicker2::drawRubberBand( QPainter* painter ) const
         return;
     }
 
-    const QPolygon pa = adjustedPoints( m_data->pickedPoints );
+    QPolygon pa;
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, AdjustedPoints );
+        pa = adjustedPoints( pickedPoints() );
+    }
 
     QwtPicker2Machine::SelectionType selectionType =
         QwtPicker2Machine::NoSelection;
@@ -660,7 +1961,7 @@ void QwtPicker2::drawRubberBand( QPainter* painter ) const
 
             const QPoint pos = pa[0];
 
-            const QRect pRect = pickArea().boundingRect().toRect();
+            const QRect pRect = pickRect();
             switch ( rubberBand() )
             {
                 case VLineRubberBand:
@@ -714,7 +2015,12 @@ void QwtPicker2::drawRubberBand( QPainter* painter ) const
         case QwtPicker2Machine::PolygonSelection:
         {
             if ( rubberBand() == PolygonRubberBand )
-                painter->drawPolyline( pa );
+            {
+                if ( painter->device() == m_data->rubberBandOverlay.data() )
+                    drawCachedPolyline( painter, pa );
+                else
+                    painter->drawPolyline( pa );
+            }
             break;
         }
         default:
@@ -722,6 +2028,81 @@ void QwtPicker2::drawRubberBand( QPainter* painter ) const
     }
 }
 
+/*!
+   \brief Draw the polyline of a polygon rubber band into its overlay
+
+   The segments between all points but the last one are retained
+   in a pixmap, so that only the newly appended segments and
+   the segment to the moving last point need to be stroked.
+
+   Removing a cached point, begin() and stretchSelection() invalidate
+   the pixmap, so are changes of the pen or the size of the overlay.
+   As reimplementations of adjustedPoints() might move any point,
+   the retained segments are validated by comparing the cached points
+   with the corresponding points of the selection.
+
+   \param painter Painter of the rubber band overlay
+   \param points Adjusted points of the selection
+ */
+void QwtPicker2::drawCachedPolyline(
+    QPainter* painter, const QPolygon& points ) const
+{
+    PrivateData* d = m_data;
+
+    const QWidget* w = d->rubberBandOverlay;
+    const int numStable = points.count() - 1;
+
+    qreal pixelRatio = 1.0;
+#if QT_VERSION >= 0x050000
+    pixelRatio = QwtPainter::devicePixelRatio( w );
+#endif
+
+    const QSize size( qCeil( w->width() * pixelRatio ),
+        qCeil( w->height() * pixelRatio ) );
+
+    if ( size.isEmpty() )
+    {
+        painter->drawPolyline( points );
+        return;
+    }
+
+    const bool isValid = ( d->polylinePixmap.size() == size )
+        && ( d->polylinePen == painter->pen() )
+        && ( d->polylineCount <= numStable )
+        && qwtHasPrefix( points, d->polylinePoints, d->polylineCount );
+
+    if ( !isValid )
+    {
+        d->polylinePixmap = QPixmap( size );
+#if QT_VERSION >= 0x050000
+        d->polylinePixmap.setDevicePixelRatio( pixelRatio );
+#endif
+        d->polylinePixmap.fill( Qt::transparent );
+
+        d->polylinePen = painter->pen();
+        d->polylineCount = 0;
+    }
+
+    if ( d->polylineCount < numStable )
+    {
+        const int from = qMax( d->polylineCount - 1, 0 );
+
+        QPainter p( &d->polylinePixmap );
+        p.setRenderHints( painter->renderHints() );
+        p.setPen( d->polylinePen );
+        p.drawPolyline( points.constData() + from, numStable - from );
+        p.end();
+
+        d->polylineCount = numStable;
+        d->polylinePoints = points.mid( 0, numStable );
+    }
+
+    painter->drawPixmap( 0, 0, d->polylinePixmap );
+
+    if ( numStable > 0 )
+        painter->drawLine( points[numStable - 1], points[numStable] );
+}
+
 /*!
    Draw the tracker
 
@@ -734,7 +2115,7 @@ void QwtPicker2::drawTracker( QPainter* painter ) const
     const QRect textRect = trackerRect( painter->font() );
     if ( !textRect.isEmpty() )
     {
-        const QwtText label = trackerText( m_data->trackerPosition );
+        const QwtText& label = cachedTrackerText();
         if ( !label.isEmpty() )
             label.draw( painter, textRect );
     }
@@ -791,7 +2172,8 @@ QPolygon QwtPicker2::adjustedPoints( const QPolygon& points ) const
  */
 QPolygon QwtPicker2::selection() const
 {
-    return adjustedPoints( m_data->pickedPoints );
+    QWT_PICKER2_SAMPLE( &m_data->statistics, AdjustedPoints );
+    return adjustedPoints( pickedPoints() );
 }
 
 //! \return Current position of the tracker
@@ -820,18 +2202,57 @@ QRect QwtPicker2::trackerRect( const QFont& font ) const
     if ( m_data->trackerPosition.x() < 0 || m_data->trackerPosition.y() < 0 )
         return QRect();
 
-    QwtText text = trackerText( m_data->trackerPosition );
+    const QwtText& text = cachedTrackerText();
     if ( text.isEmpty() )
         return QRect();
 
-    const QSizeF textSize = text.textSize( font );
+    if ( !m_data->trackerSizeValid || font != m_data->trackerSizeFont )
+    {
+        m_data->trackerSize = text.textSize( font );
+        m_data->trackerSizeFont = font;
+        m_data->trackerSizeValid = true;
+    }
 
-    const int w = qwtCeil( textSize.width() );
-    const int h = qwtCeil( textSize.height() );
+    const int w = qwtCeil( m_data->trackerSize.width() );
+    const int h = qwtCeil( m_data->trackerSize.height() );
 
     return trackerRect( QSize( w, h ) );
 }
 
+/*!
+   \brief Invalidate the cached tracker text
+
+   The text of the tracker is calculated once for each updateDisplay() and
+   shared between all calculations ( trackerRect(), trackerMask(),
+   drawTracker() ) until the next update or a change of the tracker position.
+   Derived classes have to invalidate it, when a parameter, that is used
+   in trackerText(), has been changed without updating the display.
+
+   \sa trackerText(), updateDisplay()
+ */
+void QwtPicker2::invalidateTrackerText()
+{
+    m_data->trackerTextValid = false;
+    m_data->trackerSizeValid = false;
+}
+
+//! \return trackerText() for the current tracker position
+const QwtText& QwtPicker2::cachedTrackerText() const
+{
+    if ( !m_data->trackerTextValid
+        || m_data->trackerTextPosition != m_data->trackerPosition )
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, TrackerText );
+
+        m_data->trackerText = trackerText( m_data->trackerPosition );
+        m_data->trackerTextPosition = m_data->trackerPosition;
+        m_data->trackerTextValid = true;
+        m_data->trackerSizeValid = false;
+    }
+
+    return m_data->trackerText;
+}
+
 /*! 
    Calculate the geometry of the tracker that is needed to display
    information of a specific size at the tracker position
@@ -847,11 +2268,12 @@ QRect QwtPicker2::trackerRect( const QSize& size ) const
     QRect infoRect( 0, 0, size.width(), size.height() );
 
     int alignment = 0;
-    if ( isActive() && m_data->pickedPoints.count() > 1
+    const QPolygon& points = pickedPoints();
+
+    if ( isActive() && points.count() > 1
         && rubberBand() != NoRubberBand )
     {
-        const QPoint last =
-            m_data->pickedPoints[ m_data->pickedPoints.count() - 2 ];
+        const QPoint last = points[ points.count() - 2 ];
 
         alignment |= ( pos.x() >= last.x() ) ? Qt::AlignRight : Qt::AlignLeft;
         alignment |= ( pos.y() > last.y() ) ? Qt::AlignBottom : Qt::AlignTop;
@@ -877,14 +2299,14 @@ QRect QwtPicker2::trackerRect( const QSize& size ) const
 
     infoRect.moveTopLeft( QPoint( x, y ) );
 
-    const QRect pickRect = pickArea().boundingRect().toRect();
+    const QRect pRect = pickRect();
 
-    int right = qMin( infoRect.right(), pickRect.right() - margin );
-    int bottom = qMin( infoRect.bottom(), pickRect.bottom() - margin );
+    int right = qMin( infoRect.right(), pRect.right() - margin );
+    int bottom = qMin( infoRect.bottom(), pRect.bottom() - margin );
     infoRect.moveBottomRight( QPoint( right, bottom ) );
 
-    int left = qMax( infoRect.left(), pickRect.left() + margin );
-    int top = qMax( infoRect.top(), pickRect.top() + margin );
+    int left = qMax( infoRect.left(), pRect.left() + margin );
+    int top = qMax( infoRect.top(), pRect.top() + margin );
     infoRect.moveTopLeft( QPoint( left, top ) );
 
     return infoRect;
@@ -913,12 +2335,50 @@ bool QwtPicker2::eventFilter( QObject* object, QEvent* event )
 {
     if ( object && object == parentWidget() )
     {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, EventDispatch );
+
+        if ( !m_data->sharedEventFilter )
+        {
+            qwtUpdatePointerPosition( event, m_data->pointerPosition,
+                m_data->hasPointerPosition, m_data->isPointerTracked );
+        }
+
+        if ( event->type() == QEvent::MouseMove && m_data->moveCoalescing )
+        {
+            QMouseEvent* me = static_cast< QMouseEvent* >( event );
+
+            if ( m_data->moveTimer.isActive() )
+            {
+                m_data->pendingPos = me->pos();
+#if QT_VERSION < 0x060000
+                m_data->pendingGlobalPos = me->globalPos();
+#else
+                m_data->pendingGlobalPos = me->globalPosition().toPoint();
+#endif
+                m_data->pendingButtons = me->buttons();
+                m_data->pendingModifiers = me->modifiers();
+                m_data->hasPendingMove = true;
+            }
+            else
+            {
+                m_data->moveTimer.start( qwtFrameInterval, this );
+                widgetMouseMoveEvent( me );
+            }
+
+            return false;
+        }
+
+        if ( m_data->hasPendingMove && qwtIsOrderedEvent( event->type() ) )
+            flushMouseMove();
+
         switch ( event->type() )
         {
             case QEvent::Resize:
             {
                 const QResizeEvent* re = static_cast< QResizeEvent* >( event );
 
+                invalidatePickArea();
+
                 /*
                    Adding/deleting additional event filters inside of an event filter
                    is not safe dues to the implementation in Qt ( changing a list while iterating ).
@@ -931,12 +2391,20 @@ bool QwtPicker2::eventFilter( QObject* object, QEvent* event )
                 if ( m_data->rubberBandOverlay )
                     m_data->rubberBandOverlay->resize( re->size() );
 
+                if ( m_data->sharedOverlay && m_data->sharedOverlayWidget )
+                    m_data->sharedOverlayWidget->resize( re->size() );
+
                 if ( m_data->resizeMode == Stretch )
                     stretchSelection( re->oldSize(), re->size() );
 
                 updateDisplay();
                 break;
             }
+            case QEvent::ContentsRectChange:
+            {
+                invalidatePickArea();
+                break;
+            }
             case QEvent::Enter:
             {
                 widgetEnterEvent( event );
@@ -989,6 +2457,66 @@ bool QwtPicker2::eventFilter( QObject* object, QEvent* event )
     return false;
 }
 
+/*!
+   Handle timer events
+
+   The timers are used to pace the processing of mouse moves,
+   when moveCoalescing() is enabled, to delay changed()
+   for changedDelay() and to throttle moved() according
+   to signalDelivery().
+
+   \param event Timer event
+   \sa setMoveCoalescing(), setChangedDelay(), setSignalDelivery()
+ */
+void QwtPicker2::timerEvent( QTimerEvent* event )
+{
+    if ( event->timerId() == m_data->moveTimer.timerId() )
+    {
+        if ( m_data->hasPendingMove )
+            flushMouseMove();
+        else
+            m_data->moveTimer.stop();
+
+        return;
+    }
+
+    if ( event->timerId() == m_data->changedTimer.timerId() )
+    {
+        flushChanged();
+        return;
+    }
+
+    if ( event->timerId() == m_data->signalTimer.timerId() )
+    {
+        if ( m_data->movedPositions.isEmpty() )
+            m_data->signalTimer.stop();
+        else
+            flushMoved();
+
+        return;
+    }
+
+    QObject::timerEvent( event );
+}
+
+/*!
+   Process a mouse move, that has been buffered
+   because of moveCoalescing()
+ */
+void QwtPicker2::flushMouseMove()
+{
+    if ( !m_data->hasPendingMove )
+        return;
+
+    m_data->hasPendingMove = false;
+
+    QMouseEvent event( QEvent::MouseMove, m_data->pendingPos,
+        m_data->pendingGlobalPos, Qt::NoButton,
+        m_data->pendingButtons, m_data->pendingModifiers );
+
+    widgetMouseMoveEvent( &event );
+}
+
 /*!
    Handle a mouse press event for the observed widget.
 
@@ -1014,7 +2542,7 @@ void QwtPicker2::widgetMousePressEvent( QMouseEvent* mouseEvent )
  */
 void QwtPicker2::widgetMouseMoveEvent( QMouseEvent* mouseEvent )
 {
-    if ( pickArea().contains( mouseEvent->pos() ) )
+    if ( isInsidePickArea( mouseEvent->pos() ) )
         m_data->trackerPosition = mouseEvent->pos();
     else
         m_data->trackerPosition = QPoint( -1, -1 );
@@ -1104,7 +2632,7 @@ void QwtPicker2::widgetWheelEvent( QWheelEvent* wheelEvent )
 #else
     const QPoint wheelPos = wheelEvent->position().toPoint();
 #endif
-    if ( pickArea().contains( wheelPos ) )
+    if ( isInsidePickArea( wheelPos ) )
         m_data->trackerPosition = wheelPos;
     else
         m_data->trackerPosition = QPoint( -1, -1 );
@@ -1137,15 +2665,17 @@ void QwtPicker2::widgetKeyPressEvent( QKeyEvent* keyEvent )
     if ( keyEvent->isAutoRepeat() )
         offset = 5;
 
-    if ( keyMatch( KeyLeft, keyEvent ) )
+    const int mask = keyPatternMask( keyEvent );
+
+    if ( qwtKeyMatches( *this, mask, KeyLeft, keyEvent ) )
         dx = -offset;
-    else if ( keyMatch( KeyRight, keyEvent ) )
+    else if ( qwtKeyMatches( *this, mask, KeyRight, keyEvent ) )
         dx = offset;
-    else if ( keyMatch( KeyUp, keyEvent ) )
+    else if ( qwtKeyMatches( *this, mask, KeyUp, keyEvent ) )
         dy = -offset;
-    else if ( keyMatch( KeyDown, keyEvent ) )
+    else if ( qwtKeyMatches( *this, mask, KeyDown, keyEvent ) )
         dy = offset;
-    else if ( keyMatch( KeyAbort, keyEvent ) )
+    else if ( qwtKeyMatches( *this, mask, KeyAbort, keyEvent ) )
     {
         reset();
     }
@@ -1154,8 +2684,8 @@ void QwtPicker2::widgetKeyPressEvent( QKeyEvent* keyEvent )
 
     if ( dx != 0 || dy != 0 )
     {
-        const QRect rect = pickArea().boundingRect().toRect();
-        const QPoint pos = parentWidget()->mapFromGlobal( QCursor::pos() );
+        const QRect rect = pickRect();
+        const QPoint pos = cursorPosition();
 
         int x = pos.x() + dx;
         x = qMax( rect.left(), x );
@@ -1166,6 +2696,12 @@ void QwtPicker2::widgetKeyPressEvent( QKeyEvent* keyEvent )
         y = qMin( rect.bottom(), y );
 
         QCursor::setPos( parentWidget()->mapToGlobal( QPoint( x, y ) ) );
+
+        /*
+            The mouse move for the new position is delivered later.
+            Until then auto repeated keys continue from here.
+         */
+        setCursorPosition( QPoint( x, y ) );
     }
 }
 
@@ -1185,6 +2721,178 @@ void QwtPicker2::widgetKeyReleaseEvent( QKeyEvent* keyEvent )
     transition( keyEvent );
 }
 
+/*!
+   \brief Classify a mouse event by the mouse patterns
+
+   When patternTables() is enabled, the mousePattern() is looked up
+   in a table, that maps button and modifiers to the matching
+   pattern codes.
+
+   \param event Mouse event
+   \return Bitmask, where bit i is set when the event matches
+           QwtEventPattern::MousePatternCode i. -1, when patternTables()
+           is disabled: then the pattern based mouseMatch() is used.
+
+   \note Pickers reimplementing the pattern based mouseMatch()
+         must not enable patternTables() or have to reimplement
+         mousePatternMask() accordingly.
+
+   \sa keyPatternMask(), setPatternTables(), QwtPicker2Machine::transition()
+ */
+int QwtPicker2::mousePatternMask( const QMouseEvent* event ) const
+{
+    if ( !m_data->patternTables )
+        return -1;
+
+    if ( event == NULL )
+        return 0;
+
+    if ( !m_data->patternTablesValid
+        || mousePattern().constData() != m_data->mousePatterns.constData() )
+    {
+        updatePatternTables();
+    }
+
+    return m_data->mousePatternMasks.value(
+        qwtPatternKey( event->button(), event->modifiers() ), 0 );
+}
+
+/*!
+   \brief Classify a key event by the key patterns
+
+   When patternTables() is enabled, the keyPattern() is looked up
+   in a table, that maps key and modifiers to the matching
+   pattern codes.
+
+   \param event Key event
+   \return Bitmask, where bit i is set when the event matches
+           QwtEventPattern::KeyPatternCode i. -1, when patternTables()
+           is disabled: then the pattern based keyMatch() is used.
+
+   \note Pickers reimplementing the pattern based keyMatch()
+         must not enable patternTables() or have to reimplement
+         keyPatternMask() accordingly.
+
+   \sa mousePatternMask(), setPatternTables(), QwtPicker2Machine::transition()
+ */
+int QwtPicker2::keyPatternMask( const QKeyEvent* event ) const
+{
+    if ( !m_data->patternTables )
+        return -1;
+
+    if ( event == NULL )
+        return 0;
+
+    if ( !m_data->patternTablesValid
+        || keyPattern().constData() != m_data->keyPatterns.constData() )
+    {
+        updatePatternTables();
+    }
+
+    return m_data->keyPatternMasks.value(
+        qwtPatternKey( event->key(), event->modifiers() ), 0 );
+}
+
+//! Compile mousePattern() and keyPattern() into the pattern tables
+void QwtPicker2::updatePatternTables() const
+{
+    m_data->mousePatternMasks.clear();
+
+    const QVector< MousePattern >& mousePatterns = mousePattern();
+    for ( int i = 0; i < mousePatterns.size(); i++ )
+    {
+        const quint64 key = qwtPatternKey(
+            mousePatterns[i].button, mousePatterns[i].modifiers );
+
+        m_data->mousePatternMasks[key] |= ( 1 << i );
+    }
+
+    m_data->keyPatternMasks.clear();
+
+    const QVector< KeyPattern >& keyPatterns = keyPattern();
+    for ( int i = 0; i < keyPatterns.size(); i++ )
+    {
+        const quint64 key = qwtPatternKey(
+            keyPatterns[i].key, keyPatterns[i].modifiers );
+
+        m_data->keyPatternMasks[key] |= ( 1 << i );
+    }
+
+    // shared copies for detecting modifications
+    m_data->mousePatterns = mousePatterns;
+    m_data->keyPatterns = keyPatterns;
+
+    m_data->patternTablesValid = true;
+}
+
+/*!
+   \brief Position of the pointer in coordinates of the parentWidget()
+
+   The position is taken from the last mouse, wheel or enter event,
+   as long as it is kept up to date by the observed widget: mouse tracking
+   is enabled or a mouse button is pressed. Otherwise - f.e. for an
+   idle picker without mouse tracking - QCursor::pos(), what is
+   a synchronous round trip to the display server on X11, is used.
+
+   \return Position of the pointer
+ */
+QPoint QwtPicker2::cursorPosition() const
+{
+    const QWidget* w = parentWidget();
+
+    QPoint pos;
+    bool isValid = false;
+    bool isTracked = false;
+
+    if ( m_data->sharedEventFilter )
+    {
+        // the pointer position is tracked by the shared event filter
+
+        const EventDispatcher* dispatcher = m_data->eventDispatcher;
+        if ( dispatcher )
+            isValid = dispatcher->pointerPosition( pos, isTracked );
+    }
+    else if ( m_data->hasPointerPosition )
+    {
+        pos = m_data->pointerPosition;
+        isTracked = m_data->isPointerTracked;
+        isValid = true;
+    }
+
+    if ( isValid && !isTracked )
+    {
+        // without mouse moves the position might be outdated
+        isValid = w->hasMouseTracking();
+    }
+
+    if ( !isValid )
+        pos = w->mapFromGlobal( QCursor::pos() );
+
+    return pos;
+}
+
+/*!
+   Set the last known position of the pointer
+
+   \param pos Position in coordinates of the parentWidget()
+   \sa cursorPosition()
+ */
+void QwtPicker2::setCursorPosition( const QPoint& pos )
+{
+    if ( m_data->sharedEventFilter )
+    {
+        EventDispatcher* dispatcher = m_data->eventDispatcher;
+        if ( dispatcher )
+            dispatcher->setPointerPosition( pos );
+    }
+    else
+    {
+        m_data->pointerPosition = pos;
+        m_data->hasPointerPosition = true;
+        m_data->isPointerTracked = true;
+    }
+}
+
 /*!
    Passes an event to the state machine and executes the resulting
    commands. Append and Move commands use the current position
@@ -1197,8 +2905,34 @@ void QwtPicker2::transition( const QEvent* event )
     if ( !m_data->stateMachine )
         return;
 
-    const QList< QwtPicker2Machine::Command > commandList =
-        m_data->stateMachine->transition( *this, event );
+    // -1: the event has not been classified
+    int patternMask = -1;
+    switch ( event->type() )
+    {
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        {
+            patternMask = mousePatternMask(
+                static_cast< const QMouseEvent* >( event ) );
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            patternMask = keyPatternMask(
+                static_cast< const QKeyEvent* >( event ) );
+            break;
+        }
+        default:
+            break;
+    }
+
+    QwtPicker2Machine::CommandBuffer commandList;
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, Transition );
+        m_data->stateMachine->dispatch( *this, event, patternMask, commandList );
+    }
 
     QPoint pos;
     switch ( event->type() )
@@ -1214,12 +2948,17 @@ void QwtPicker2::transition( const QEvent* event )
             break;
         }
         default:
-            pos = parentWidget()->mapFromGlobal( QCursor::pos() );
+            pos = cursorPosition();
     }
 
     for ( int i = 0; i < commandList.count(); i++ )
     {
-        switch ( commandList[i] )
+        const QwtPicker2Machine::Command command = commandList[i];
+
+        QwtPicker2Trace::Scope scope( m_data->trace,
+            qwtCommandName( command ), this );
+
+        switch ( command )
         {
             case QwtPicker2Machine::Begin:
             {
@@ -1247,6 +2986,12 @@ void QwtPicker2::transition( const QEvent* event )
                 break;
             }
         }
+
+        if ( m_data->trace )
+        {
+            scope.setArguments( qwtMachineState( m_data->stateMachine ),
+                m_data->points.count() );
+        }
     }
 }
 
@@ -1260,9 +3005,21 @@ void QwtPicker2::begin()
     if ( m_data->isActive )
         return;
 
+    m_data->points.clear();
+    m_data->xScale = m_data->yScale = 1.0;
+    m_data->stretchSize = QSize();
+
     m_data->pickedPoints.clear();
+    m_data->pickedPointsValid = true;
+
+    m_data->polylinePixmap = QPixmap();
+    m_data->polygonMaskCount = -1;
     m_data->isActive = true;
-    Q_EMIT activated( true );
+
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+        Q_EMIT activated( true );
+    }
 
     if ( trackerMode() != AlwaysOff )
     {
@@ -1270,7 +3027,7 @@ void QwtPicker2::begin()
         {
             QWidget* w = parentWidget();
             if ( w )
-                m_data->trackerPosition = w->mapFromGlobal( QCursor::pos() );
+                m_data->trackerPosition = cursorPosition();
         }
     }
 
@@ -1292,21 +3049,50 @@ bool QwtPicker2::end( bool ok )
 {
     if ( m_data->isActive )
     {
+        flushMoved();
+        flushChanged();
+
         setMouseTracking( false );
 
         m_data->isActive = false;
-        Q_EMIT activated( false );
+
+        {
+            QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+            Q_EMIT activated( false );
+        }
 
         if ( trackerMode() == ActiveOnly )
             m_data->trackerPosition = QPoint( -1, -1 );
 
+        QPolygon points = pickedPoints();
+
         if ( ok )
-            ok = accept( m_data->pickedPoints );
+            ok = accept( points );
+
+        if ( ok )
+        {
+            if ( points != m_data->pickedPoints )
+            {
+                // accept() has modified the selection
+                m_data->points.resize( points.count() );
+                for ( int i = 0; i < points.count(); i++ )
+                {
+                    m_data->points[i] = QPointF( points[i].x() / m_data->xScale,
+                        points[i].y() / m_data->yScale );
+                }
+
+                m_data->pickedPoints = points;
+            }
 
-        if ( ok )
-            Q_EMIT selected( m_data->pickedPoints );
+            QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+            Q_EMIT selected( points );
+        }
         else
+        {
+            m_data->points.clear();
             m_data->pickedPoints.clear();
+            m_data->pickedPointsValid = true;
+        }
 
         updateDisplay();
     }
@@ -1340,31 +3126,71 @@ void QwtPicker2::append( const QPoint& pos )
 {
     if ( m_data->isActive )
     {
-        m_data->pickedPoints += pos;
+        m_data->points += QPointF( pos.x() / m_data->xScale,
+            pos.y() / m_data->yScale );
+
+        if ( m_data->pickedPointsValid )
+            m_data->pickedPoints += pos;
 
         updateDisplay();
+
+        flushMoved();
+
+        QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
         Q_EMIT appended( pos );
     }
 }
 
 /*!
    Move the last point of the selection
-   The moved() signal is emitted.
+   The moved() signal is emitted - depending on signalDelivery().
 
    \param pos New position
    \sa isActive(), begin(), end(), append()
  */
 void QwtPicker2::move( const QPoint& pos )
 {
-    if ( m_data->isActive && !m_data->pickedPoints.isEmpty() )
+    if ( m_data->isActive && !m_data->points.isEmpty() )
     {
+        updatePickedPoints();
+
         QPoint& point = m_data->pickedPoints.last();
         if ( point != pos )
         {
             point = pos;
+            m_data->points.last() = QPointF( pos.x() / m_data->xScale,
+                pos.y() / m_data->yScale );
 
             updateDisplay();
-            Q_EMIT moved( pos );
+
+            if ( m_data->signalDelivery == ImmediateDelivery )
+            {
+                if ( isMovedPathConnected() )
+                {
+                    m_data->movedPositions += pos;
+                    flushMoved();
+                }
+                else
+                {
+                    QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+                    notifyMoved( pos );
+                }
+            }
+            else
+            {
+                m_data->movedPositions += pos;
+
+                if ( !m_data->signalTimer.isActive() )
+                {
+                    // the first move after a pause is delivered immediately
+                    flushMoved();
+
+                    const int interval = ( m_data->signalDelivery == FrameDelivery )
+                        ? qwtFrameInterval : m_data->signalInterval;
+
+                    m_data->signalTimer.start( interval, this );
+                }
+            }
         }
     }
 }
@@ -1377,16 +3203,30 @@ void QwtPicker2::move( const QPoint& pos )
  */
 void QwtPicker2::remove()
 {
-    if ( m_data->isActive && !m_data->pickedPoints.isEmpty() )
+    if ( m_data->isActive && !m_data->points.isEmpty() )
     {
+        updatePickedPoints();
+
 #if QT_VERSION >= 0x050100
         const QPoint pos = m_data->pickedPoints.takeLast();
 #else
         const QPoint pos = m_data->pickedPoints.last();
         m_data->pickedPoints.resize( m_data->pickedPoints.count() - 1 );
 #endif
+        m_data->points.resize( m_data->points.count() - 1 );
+
+        // the cached segments to the removed point are not valid anymore
+        const int count = m_data->points.count();
+        if ( m_data->polylineCount >= count )
+            m_data->polylinePixmap = QPixmap();
+        if ( m_data->polygonMaskCount >= count )
+            m_data->polygonMaskCount = -1;
 
         updateDisplay();
+
+        flushMoved();
+
+        QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
         Q_EMIT removed( pos );
     }
 }
@@ -1421,37 +3261,332 @@ bool QwtPicker2::isActive() const
  */
 const QPolygon& QwtPicker2::pickedPoints() const
 {
+    updatePickedPoints();
     return m_data->pickedPoints;
 }
 
+/*!
+   Map the stored points into widget coordinates,
+   when the widget has been resized.
+ */
+void QwtPicker2::updatePickedPoints() const
+{
+    if ( m_data->pickedPointsValid )
+        return;
+
+    const QPolygonF& points = m_data->points;
+
+    QPolygon& pickedPoints = m_data->pickedPoints;
+    pickedPoints.resize( points.count() );
+
+    for ( int i = 0; i < points.count(); i++ )
+    {
+        pickedPoints[i] = QPoint( qRound( points[i].x() * m_data->xScale ),
+            qRound( points[i].y() * m_data->yScale ) );
+    }
+
+    m_data->pickedPointsValid = true;
+}
+
 /*!
    Scale the selection by the ratios of oldSize and newSize
-   The changed() signal is emitted.
+   The changed() signal is emitted once for all points - delayed
+   by changedDelay(). It is not emitted, when there are no points.
 
    \param oldSize Previous size
    \param newSize Current size
 
-   \sa ResizeMode, setResizeMode(), resizeMode()
+   \sa ResizeMode, setResizeMode(), resizeMode(), setChangedDelay()
  */
 void QwtPicker2::stretchSelection( const QSize& oldSize, const QSize& newSize )
 {
-    if ( oldSize.isEmpty() )
+    /*
+        The points are not rounded, when being scaled. So we can
+        keep them, while the widget is empty and scale them from
+        the last size, that was not empty.
+     */
+    if ( !oldSize.isEmpty() )
+        m_data->stretchSize = oldSize;
+
+    if ( newSize.isEmpty() || m_data->stretchSize.isEmpty() )
+        return;
+
+    const QSize& size = m_data->stretchSize;
+
+    m_data->xScale *= double( newSize.width() ) / double( size.width() );
+    m_data->yScale *= double( newSize.height() ) / double( size.height() );
+
+    m_data->stretchSize = newSize;
+
+    // mapped to widget coordinates on demand
+    m_data->pickedPointsValid = false;
+
+    // all segments have been moved
+    m_data->polylinePixmap = QPixmap();
+    m_data->polygonMaskCount = -1;
+
+    if ( m_data->points.isEmpty() )
+    {
+        // nothing has changed for idle pickers
+        return;
+    }
+
+    if ( m_data->changedDelay > 0 )
+    {
+        // restarting the timer: changed() is emitted, when resizing stops
+        m_data->changedTimer.start( m_data->changedDelay, this );
+    }
+    else
+    {
+        QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+        Q_EMIT changed( pickedPoints() );
+    }
+}
+
+/*!
+   \brief Set the policy for emitting moved()
+
+   At high pointer rates receivers of moved() might flood
+   the event loop. With FrameDelivery or IntervalDelivery moved()
+   is emitted for the last position only, when a previous
+   signal has been emitted less than a frame or signalInterval()
+   ago. The positions in between are not lost: they are
+   delivered by movedPath().
+
+   Pending moves are delivered before appended(), removed()
+   or the signals of the end of a selection.
+
+   The default setting is ImmediateDelivery.
+
+   \param delivery Delivery policy
+   \sa signalDelivery(), setSignalInterval(), notifyMoved()
+ */
+void QwtPicker2::setSignalDelivery( SignalDelivery delivery )
+{
+    if ( m_data->signalDelivery != delivery )
     {
-        // avoid division by zero. But scaling for small sizes also
-        // doesn't make much sense, because of rounding losses. TODO ...
+        m_data->signalDelivery = delivery;
+
+        flushMoved();
+        m_data->signalTimer.stop();
+    }
+}
+
+/*!
+   \return Policy for emitting moved()
+   \sa setSignalDelivery()
+ */
+QwtPicker2::SignalDelivery QwtPicker2::signalDelivery() const
+{
+    return m_data->signalDelivery;
+}
+
+/*!
+   Set the minimum interval between two moved() signals
+   for IntervalDelivery
+
+   \param msecs Interval in milliseconds
+   \sa signalInterval(), setSignalDelivery()
+ */
+void QwtPicker2::setSignalInterval( int msecs )
+{
+    m_data->signalInterval = qMax( msecs, 1 );
+}
+
+/*!
+   \return Minimum interval between two moved() signals
+   \sa setSignalInterval(), setSignalDelivery()
+ */
+int QwtPicker2::signalInterval() const
+{
+    return m_data->signalInterval;
+}
+
+/*!
+   \brief Assign a trace for the activity of the picker
+
+   The commands of the state machine, the updates of the display
+   and the paint operations of the overlays are written as trace
+   events, with the state of the state machine and the number of
+   picked points as arguments. The trace is not owned by the picker
+   and might be shared with other pickers.
+
+   \param trace Trace, or NULL to stop tracing
+   \sa trace()
+ */
+void QwtPicker2::setTrace( QwtPicker2Trace* trace )
+{
+    m_data->trace = trace;
+}
+
+/*!
+   \return Trace for the activity of the picker
+   \sa setTrace()
+ */
+QwtPicker2Trace* QwtPicker2::trace() const
+{
+    return m_data->trace;
+}
+
+/*!
+   \return Latency statistics of the picker, or NULL, when the library
+           has been built without QWT_PICKER2_STATISTICS
+   \sa resetStatistics()
+ */
+QwtPicker2Statistics* QwtPicker2::statistics()
+{
+#ifdef QWT_PICKER2_STATISTICS
+    return &m_data->statistics;
+#else
+    return NULL;
+#endif
+}
+
+/*!
+   \return Latency statistics of the picker, or NULL, when the library
+           has been built without QWT_PICKER2_STATISTICS
+   \sa resetStatistics()
+ */
+const QwtPicker2Statistics* QwtPicker2::statistics() const
+{
+#ifdef QWT_PICKER2_STATISTICS
+    return &m_data->statistics;
+#else
+    return NULL;
+#endif
+}
+
+/*!
+   Clear the latency statistics
+   \sa statistics()
+ */
+void QwtPicker2::resetStatistics()
+{
+#ifdef QWT_PICKER2_STATISTICS
+    m_data->statistics.reset();
+#endif
+}
+
+/*!
+   Deliver the positions of the moves, that have been
+   delayed by signalDelivery()
+ */
+void QwtPicker2::flushMoved()
+{
+    if ( m_data->movedPositions.isEmpty() )
+        return;
+
+    // includes the signals of notifyMoved() in derived classes
+    QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+
+    if ( !isMovedPathConnected() )
+    {
+        const QPoint pos = m_data->movedPositions.last();
+
+        // resize( 0 ) keeps the capacity
+        m_data->movedPositions.resize( 0 );
+
+        notifyMoved( pos );
         return;
     }
 
-    const double xRatio = double( newSize.width() ) / double( oldSize.width() );
-    const double yRatio = double( newSize.height() ) / double( oldSize.height() );
+    /*
+        The receivers might trigger new moves, so the positions are
+        taken out, before emitting. Afterwards the buffer is given back
+        to reuse its capacity.
+     */
+    QPolygon path;
+    path.swap( m_data->movedPositions );
+
+    notifyMoved( path.last() );
+    Q_EMIT movedPath( path );
+
+    if ( m_data->movedPositions.isEmpty() )
+    {
+        path.resize( 0 );
+        path.swap( m_data->movedPositions );
+    }
+}
+
+//! \return True, when movedPath() has been connected
+bool QwtPicker2::isMovedPathConnected() const
+{
+#if QT_VERSION >= 0x050000
+    static const QMetaMethod signal =
+        QMetaMethod::fromSignal( &QwtPicker2::movedPath );
+
+    return isSignalConnected( signal );
+#else
+    return receivers( SIGNAL(movedPath(QPolygon)) ) > 0;
+#endif
+}
+
+/*!
+   \brief Emit the moved() signals
+
+   notifyMoved() is called for each move or, depending on
+   signalDelivery(), for the last of several moves.
+
+   \param pos Position of the moved last point
+   \sa setSignalDelivery(), move()
+ */
+void QwtPicker2::notifyMoved( const QPoint& pos )
+{
+    Q_EMIT moved( pos );
+}
+
+/*!
+   \brief Set a delay for the changed() signal
+
+   When the parentWidget() is resized during a selection,
+   stretchSelection() emits changed() for each resize event.
+   For receivers doing expensive work for changed() it might
+   be better to wait until an interactive resize operation
+   has been finished.
+
+   For a delay > 0 changed() is emitted, when no other
+   resize has happened for delay milliseconds. Pending
+   notifications are emitted before a selection is terminated.
+
+   The default setting is 0, what emits changed() immediately.
+
+   \param msecs Delay in milliseconds
+   \sa changedDelay(), stretchSelection()
+ */
+void QwtPicker2::setChangedDelay( int msecs )
+{
+    msecs = qMax( msecs, 0 );
+
+    if ( m_data->changedDelay != msecs )
+    {
+        m_data->changedDelay = msecs;
+
+        if ( msecs == 0 )
+            flushChanged();
+    }
+}
+
+/*!
+   \return Delay for the changed() signal in milliseconds
+   \sa setChangedDelay()
+ */
+int QwtPicker2::changedDelay() const
+{
+    return m_data->changedDelay;
+}
 
-    for ( int i = 0; i < m_data->pickedPoints.count(); i++ )
+/*!
+   Emit a changed() signal, that has been delayed
+   because of changedDelay()
+ */
+void QwtPicker2::flushChanged()
+{
+    if ( m_data->changedTimer.isActive() )
     {
-        QPoint& p = m_data->pickedPoints[i];
-        p.setX( qRound( p.x() * xRatio ) );
-        p.setY( qRound( p.y() * yRatio ) );
+        m_data->changedTimer.stop();
 
-        Q_EMIT changed( m_data->pickedPoints );
+        QWT_PICKER2_SAMPLE( &m_data->statistics, SignalEmission );
+        Q_EMIT changed( pickedPoints() );
     }
 }
 
@@ -1501,11 +3636,86 @@ QPainterPath QwtPicker2::pickArea() const
     return path;
 }
 
+/*!
+   \brief Invalidate the cached pick area
+
+   The result of pickArea() is cached and recalculated, when
+   the size or the contents rectangle of the observed widget
+   have been changed - even while the picker has been disabled.
+   Derived classes, that reimplement pickArea(), have to
+   invalidate the cache, when the pick area changes for other reasons.
+
+   \sa pickArea(), pickRect(), isInsidePickArea()
+ */
+void QwtPicker2::invalidatePickArea()
+{
+    m_data->pickAreaValid = false;
+}
+
+/*!
+   \return Bounding rectangle of the pickArea()
+   \sa isInsidePickArea(), invalidatePickArea()
+ */
+QRect QwtPicker2::pickRect() const
+{
+    updatePickArea();
+    return m_data->pickRect;
+}
+
+/*!
+   \param pos Position
+   \return True, when pos is inside of the pickArea()
+   \sa pickRect(), invalidatePickArea()
+ */
+bool QwtPicker2::isInsidePickArea( const QPoint& pos ) const
+{
+    updatePickArea();
+
+    if ( m_data->pickAreaIsRect )
+        return m_data->pickRect.contains( pos );
+
+    return m_data->pickArea.contains( pos );
+}
+
+//! Recalculate the cached pickArea(), when it has been invalidated
+void QwtPicker2::updatePickArea() const
+{
+    const QWidget* widget = parentWidget();
+
+    const QSize size = widget ? widget->size() : QSize();
+    const QRect contentsRect = widget ? widget->contentsRect() : QRect();
+
+    if ( m_data->pickAreaValid && size == m_data->pickAreaWidgetSize
+        && contentsRect == m_data->pickAreaContentsRect )
+    {
+        return;
+    }
+
+    const QPainterPath path = pickArea();
+    const QRectF boundingRect = path.boundingRect();
+
+    QPainterPath rectPath;
+    rectPath.addRect( boundingRect );
+
+    m_data->pickArea = path;
+    m_data->pickRect = boundingRect.toRect();
+    m_data->pickAreaIsRect = ( path == rectPath );
+    m_data->pickAreaWidgetSize = size;
+    m_data->pickAreaContentsRect = contentsRect;
+    m_data->pickAreaValid = true;
+}
+
 //! Update the state of rubber band and tracker label
 void QwtPicker2::updateDisplay()
 {
+    QwtPicker2Trace::Scope scope( m_data->trace, "updateDisplay", this,
+        qwtMachineState( m_data->stateMachine ), m_data->points.count() );
+
     QWidget* w = parentWidget();
 
+    // the tracker text is cached for one update only
+    m_data->trackerTextValid = false;
+
     bool showRubberband = false;
     bool showTracker = false;
 
@@ -1521,13 +3731,53 @@ void QwtPicker2::updateDisplay()
             ( trackerMode() == ActiveOnly && isActive() ) )
         {
             if ( trackerPen() != Qt::NoPen
-                && !trackerRect( QFont() ).isEmpty() )
+                && !trackerRect( m_data->trackerFont ).isEmpty() )
             {
                 showTracker = true;
             }
         }
     }
 
+    if ( m_data->sharedOverlay && w )
+    {
+        qwtDeleteOverlay( m_data->rubberBandOverlay, m_data->openGL );
+        qwtDeleteOverlay( m_data->trackerOverlay, m_data->openGL );
+
+        // the incremental updates are not used for the shared overlay
+        m_data->polygonMaskChanged = QRegion();
+        m_data->rubberBandRegion = QRegion();
+
+        if ( !showRubberband )
+        {
+            m_data->polygonMaskCount = 0;
+            m_data->polygonMask = QRegion();
+            m_data->polygonMaskTail = QRegion();
+            m_data->polygonMaskTailCount = -1;
+        }
+
+        QPointer< SharedOverlay >& overlay = m_data->sharedOverlayWidget;
+        if ( overlay.isNull() || overlay->isRetired() )
+            overlay = SharedOverlay::find( w );
+
+        if ( overlay.isNull() && ( showRubberband || showTracker ) )
+        {
+            overlay = new SharedOverlay();
+            overlay->setParent( w );
+            overlay->resize( w->size() );
+        }
+
+        if ( overlay )
+        {
+            // the pickers, that resize the overlay, might be disabled
+            if ( overlay->size() != w->size() )
+                overlay->resize( w->size() );
+
+            overlay->setDisplay( this, showRubberband, showTracker );
+        }
+
+        return;
+    }
+
     QPointer< Rubberband >& rw = m_data->rubberBandOverlay;
     if ( showRubberband )
     {
@@ -1538,29 +3788,100 @@ void QwtPicker2::updateDisplay()
             rw->setParent( w );
             rw->resize( w->size() );
         }
+        else if ( rw->size() != w->size() )
+        {
+            // a persistent overlay misses resizes of a disabled picker
+            rw->resize( w->size() );
+        }
+
+        const bool isPolygon = ( m_data->rubberBand == PolygonRubberBand )
+            && m_data->stateMachine && ( m_data->stateMachine->selectionType()
+                == QwtPicker2Machine::PolygonSelection );
+
+        if ( qwtIsLineRubberBand( m_data->rubberBand ) || isPolygon )
+        {
+            /*
+                Changing the mask of the overlay for each move results
+                in repainting the area below the old and the new mask.
+                For lines we better use an overlay without mask
+                and repaint the strips of the old and the new lines only.
+                For polygons these are the segments, that have been
+                appended or moved.
+             */
+            QRegion dirty;
+            if ( isPolygon )
+            {
+                // only the changes are needed, not the complete mask
+                {
+                    QWT_PICKER2_SAMPLE( &m_data->statistics, RubberBandMask );
+
+                    QPolygon pa;
+                    {
+                        QWT_PICKER2_SAMPLE( &m_data->statistics, AdjustedPoints );
+                        pa = adjustedPoints( pickedPoints() );
+                    }
+
+                    const int pw = qCeil( rubberBandPen().widthF()
+                        * QwtPainter::devicePixelRatio( w ) );
+
+                    updatePolygonMask( pa, pw );
+                }
+
+                dirty = m_data->polygonMaskChanged;
+                m_data->polygonMaskChanged = QRegion();
+            }
+            else
+            {
+                QRegion region;
+                {
+                    QWT_PICKER2_SAMPLE( &m_data->statistics, RubberBandMask );
+                    region = rubberBandMask();
+                }
+
+                dirty = region + m_data->rubberBandRegion;
+                m_data->rubberBandRegion = region;
+            }
 
-        if ( m_data->rubberBand <= RectRubberBand )
-            rw->setMaskMode( QwtWidgetOverlay::MaskHint );
+            if ( rw->maskMode() != QwtWidgetOverlay::NoMask || !rw->isVisible() )
+            {
+                rw->setMaskMode( QwtWidgetOverlay::NoMask );
+                rw->updateOverlay();
+            }
+            else
+            {
+                rw->update( dirty );
+            }
+        }
         else
-            rw->setMaskMode( QwtWidgetOverlay::AlphaMask );
+        {
+            if ( m_data->rubberBand <= EllipseRubberBand )
+                rw->setMaskMode( QwtWidgetOverlay::MaskHint );
+            else
+                rw->setMaskMode( QwtWidgetOverlay::AlphaMask );
 
-        rw->updateOverlay();
+            rw->updateOverlay();
+        }
     }
     else
     {
-        if ( m_data->openGL )
+        m_data->rubberBandRegion = QRegion();
+
+        m_data->polygonMaskCount = 0;
+        m_data->polygonMask = QRegion();
+        m_data->polygonMaskTail = QRegion();
+        m_data->polygonMaskTailCount = -1;
+        m_data->polygonMaskChanged = QRegion();
+
+        m_data->polylinePixmap = QPixmap();
+
+        if ( m_data->persistentOverlays )
         {
-            // Qt 4.8 crashes for a delete
             if ( !rw.isNull() )
-            {
                 rw->hide();
-                rw->deleteLater();
-                rw = NULL;
-            }
         }
         else
         {
-            delete rw;
+            qwtDeleteOverlay( rw, m_data->openGL );
         }
     }
 
@@ -1574,24 +3895,23 @@ void QwtPicker2::updateDisplay()
             tw->setParent( w );
             tw->resize( w->size() );
         }
+        else if ( tw->size() != w->size() )
+        {
+            tw->resize( w->size() );
+        }
         tw->setFont( m_data->trackerFont );
         tw->updateOverlay();
     }
     else
     {
-        if ( m_data->openGL )
+        if ( m_data->persistentOverlays )
         {
-            // Qt 4.8 crashes for a delete
             if ( !tw.isNull() )
-            {
                 tw->hide();
-                tw->deleteLater();
-                tw = NULL;
-            }
         }
         else
         {
-            delete tw;
+            qwtDeleteOverlay( tw, m_data->openGL );
         }
     }
 }
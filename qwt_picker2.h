@@ -16,12 +16,15 @@
 #include <qobject.h>
 
 class QwtPicker2Machine;
+class QwtPicker2Statistics;
+class QwtPicker2Trace;
 class QwtWidgetOverlay;
 class QwtText;
 class QWidget;
 class QMouseEvent;
 class QWheelEvent;
 class QKeyEvent;
+class QTimerEvent;
 class QPainter;
 class QPen;
 class QFont;
@@ -104,10 +107,19 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
 {
     Q_OBJECT
 
-    Q_ENUMS( RubberBand DisplayMode ResizeMode )
+    Q_ENUMS( RubberBand DisplayMode ResizeMode SignalDelivery )
 
     Q_PROPERTY( bool isEnabled READ isEnabled WRITE setEnabled )
     Q_PROPERTY( ResizeMode resizeMode READ resizeMode WRITE setResizeMode )
+    Q_PROPERTY( bool moveCoalescing READ moveCoalescing WRITE setMoveCoalescing )
+    Q_PROPERTY( bool patternTables READ patternTables WRITE setPatternTables )
+    Q_PROPERTY( bool persistentOverlays READ persistentOverlays WRITE setPersistentOverlays )
+    Q_PROPERTY( bool sharedOverlay READ sharedOverlay WRITE setSharedOverlay )
+    Q_PROPERTY( bool sharedEventFilter READ sharedEventFilter WRITE setSharedEventFilter )
+    Q_PROPERTY( bool prefilterEvents READ prefilterEvents WRITE setPrefilterEvents )
+    Q_PROPERTY( int changedDelay READ changedDelay WRITE setChangedDelay )
+    Q_PROPERTY( SignalDelivery signalDelivery READ signalDelivery WRITE setSignalDelivery )
+    Q_PROPERTY( int signalInterval READ signalInterval WRITE setSignalInterval )
 
     Q_PROPERTY( DisplayMode trackerMode READ trackerMode WRITE setTrackerMode )
     Q_PROPERTY( QPen trackerPen READ trackerPen WRITE setTrackerPen )
@@ -187,6 +199,24 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
         KeepSize
     };
 
+    /*!
+       Controls how often the moved() signals are emitted
+
+       The default value is QwtPicker2::ImmediateDelivery.
+       \sa setSignalDelivery(), movedPath()
+     */
+    enum SignalDelivery
+    {
+        //! moved() is emitted for each move
+        ImmediateDelivery,
+
+        //! moved() is emitted once per display frame at most
+        FrameDelivery,
+
+        //! moved() is emitted once per signalInterval() at most
+        IntervalDelivery
+    };
+
     explicit QwtPicker2( QWidget* parent );
     explicit QwtPicker2( RubberBand rubberBand,
         DisplayMode trackerMode, QWidget* );
@@ -206,6 +236,43 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
     void setResizeMode( ResizeMode );
     ResizeMode resizeMode() const;
 
+    void setMoveCoalescing( bool );
+    bool moveCoalescing() const;
+
+    void setPatternTables( bool );
+    bool patternTables() const;
+    void invalidatePatternTables();
+
+    void setPersistentOverlays( bool );
+    bool persistentOverlays() const;
+
+    void releaseOverlays();
+
+    void setSharedOverlay( bool );
+    bool sharedOverlay() const;
+
+    void setSharedEventFilter( bool );
+    bool sharedEventFilter() const;
+
+    void setPrefilterEvents( bool );
+    bool prefilterEvents() const;
+
+    void setChangedDelay( int msecs );
+    int changedDelay() const;
+
+    void setSignalDelivery( SignalDelivery );
+    SignalDelivery signalDelivery() const;
+
+    void setSignalInterval( int msecs );
+    int signalInterval() const;
+
+    void setTrace( QwtPicker2Trace* );
+    QwtPicker2Trace* trace() const;
+
+    QwtPicker2Statistics* statistics();
+    const QwtPicker2Statistics* statistics() const;
+    void resetStatistics();
+
     void setRubberBandPen( const QPen& );
     QPen rubberBandPen() const;
 
@@ -237,6 +304,9 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
 
     QPolygon selection() const;
 
+    virtual int mousePatternMask( const QMouseEvent* ) const;
+    virtual int keyPatternMask( const QKeyEvent* ) const;
+
   public Q_SLOTS:
     void setEnabled( bool );
 
@@ -275,6 +345,17 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
      */
     void moved( const QPoint& pos );
 
+    /*!
+       A signal emitted together with moved(), carrying all positions
+       of the last point since the previous delivery. Depending on
+       signalDelivery() moved() might be emitted for the last of
+       these positions only.
+
+       \param path Positions of the moved last point
+       \sa moved(), setSignalDelivery()
+     */
+    void movedPath( const QPolygon& path );
+
     /*!
        A signal emitted whenever the last appended point of the
        selection has been removed.
@@ -301,6 +382,8 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
     virtual void append( const QPoint& );
     virtual void move( const QPoint& );
     virtual void remove();
+
+    virtual void notifyMoved( const QPoint& );
     virtual bool end( bool ok = true );
 
     virtual bool accept( QPolygon& ) const;
@@ -321,16 +404,41 @@ class QWT_EXPORT QwtPicker2 : public QObject, public QwtEventPattern
 
     virtual void updateDisplay();
 
+    virtual void timerEvent( QTimerEvent* ) QWT_OVERRIDE;
+
     const QwtWidgetOverlay* rubberBandOverlay() const;
     const QwtWidgetOverlay* trackerOverlay() const;
 
     const QPolygon& pickedPoints() const;
     QRect trackerRect( const QSize& ) const;
 
+    void invalidateTrackerText();
+    void invalidatePickArea();
+
+    QRect pickRect() const;
+    bool isInsidePickArea( const QPoint& ) const;
+
   private:
     void init( QWidget*, RubberBand rubberBand, DisplayMode trackerMode );
 
     void setMouseTracking( bool );
+    void flushMouseMove();
+
+    void flushChanged();
+    void flushMoved();
+    bool isMovedPathConnected() const;
+
+    QPoint cursorPosition() const;
+    void setCursorPosition( const QPoint& );
+
+    const QwtText& cachedTrackerText() const;
+    void updatePickArea() const;
+    void updatePickedPoints() const;
+
+    QRegion polygonMask( const QPolygon&, int penWidth ) const;
+    void updatePolygonMask( const QPolygon&, int penWidth ) const;
+    void updatePatternTables() const;
+    void drawCachedPolyline( QPainter*, const QPolygon& ) const;
 
     class PrivateData;
     PrivateData* m_data;
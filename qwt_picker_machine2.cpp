@@ -11,11 +11,14 @@
 #include "qwt_event_pattern.h"
 
 #include <qevent.h>
+#include <qlist.h>
+#include <qvector.h>
 
 //! Constructor
 QwtPicker2Machine::QwtPicker2Machine( SelectionType type )
     : m_selectionType( type )
     , m_state( 0 )
+    , m_bufferDispatch( false )
 {
 }
 
@@ -42,501 +45,589 @@ void QwtPicker2Machine::setState( int state )
     m_state = state;
 }
 
+/*!
+   \brief Check if an event might result in a transition
+
+   Observers like QwtPicker2 use this hint to avoid passing events,
+   that are ignored in the current state. The default
+   implementation returns always true.
+
+   \param eventType QEvent::Type
+   \return true, when the machine might process the event
+ */
+bool QwtPicker2Machine::acceptsEvent( int eventType ) const
+{
+    Q_UNUSED( eventType );
+    return true;
+}
+
 //! Set the current state to 0.
 void QwtPicker2Machine::reset()
 {
     setState( 0 );
 }
 
-//! Constructor
-QwtPicker2TrackerMachine::QwtPicker2TrackerMachine():
-    QwtPicker2Machine( NoSelection )
+/*!
+   \brief Select the transition() method, that is used by dispatch()
+
+   Machines, that implement the CommandBuffer based transition() methods,
+   enable buffer dispatching, so that dispatch() doesn't allocate
+   any memory. All predefined state machines do so.
+
+   The default setting is false: the list based transition() is called,
+   like it has always been. Machines derived from one of the predefined
+   machines, that reimplement the list based transition(),
+   have to disable buffer dispatching in their constructor.
+
+   \param on On/Off
+   \sa bufferDispatch(), dispatch()
+ */
+void QwtPicker2Machine::setBufferDispatch( bool on )
 {
+    m_bufferDispatch = on;
 }
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2TrackerMachine::transition(
-    const QwtEventPattern&, const QEvent* e )
+/*!
+   \return True, when dispatch() uses the CommandBuffer based transition()
+   \sa setBufferDispatch()
+ */
+bool QwtPicker2Machine::bufferDispatch() const
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    return m_bufferDispatch;
+}
+
+/*!
+   \brief Pass an event to the state machine
+
+   dispatch() is used by QwtPicker2 to pass an event to the
+   transition() method, that is selected by bufferDispatch():
+
+   - transition( const QwtEventPattern&, const QEvent*, CommandBuffer& ),
+     when buffer dispatching is enabled and the event has not been classified
+   - transition( const QwtEventPattern&, const QEvent*, int, CommandBuffer& ),
+     when buffer dispatching is enabled and the event has been classified
+   - the list based transition() otherwise
+
+   As QwtPicker2 classifies events only, when QwtPicker2::patternTables()
+   is enabled, reimplementing the 3 argument CommandBuffer based
+   transition() is sufficient otherwise.
 
-    switch ( e->type() )
+   \param eventPattern Event pattern
+   \param event Event
+   \param patternMask Matching pattern codes, or -1 when
+                      the event has not been classified
+   \param cmdBuffer Buffer for the resulting commands
+
+   \sa setBufferDispatch()
+ */
+void QwtPicker2Machine::dispatch( const QwtEventPattern& eventPattern,
+    const QEvent* event, int patternMask, CommandBuffer& cmdBuffer )
+{
+    if ( m_bufferDispatch )
     {
-        case QEvent::Enter:
-        case QEvent::MouseMove:
-        {
-            if ( state() == 0 )
-            {
-                cmdList += Begin;
-                cmdList += Append;
-                setState( 1 );
-            }
-            else
-            {
-                cmdList += Move;
-            }
-            break;
-        }
-        case QEvent::Leave:
-        {
-            cmdList += Remove;
-            cmdList += End;
-            setState( 0 );
-        }
-        default:
-            break;
+        if ( patternMask < 0 )
+            transition( eventPattern, event, cmdBuffer );
+        else
+            transition( eventPattern, event, patternMask, cmdBuffer );
+
+        return;
     }
 
-    return cmdList;
+    const QList< Command > cmdList = transition( eventPattern, event );
+
+    cmdBuffer.clear();
+    for ( int i = 0; i < cmdList.count(); i++ )
+        cmdBuffer += cmdList[i];
 }
 
-//! Constructor
-QwtPicker2ClickPointMachine::QwtPicker2ClickPointMachine():
-    QwtPicker2Machine( PointSelection )
+/*!
+   \brief Transition
+
+   Translates an event into commands, that are stored in
+   a buffer without allocating memory.
+
+   The default implementation copies the commands of the list based
+   transition(). Machines reimplementing this method usually enable
+   setBufferDispatch().
+
+   \param eventPattern Event pattern
+   \param event Event
+   \param cmdBuffer Buffer for the resulting commands
+ */
+void QwtPicker2Machine::transition( const QwtEventPattern& eventPattern,
+    const QEvent* event, CommandBuffer& cmdBuffer )
 {
+    const QList< Command > cmdList = transition( eventPattern, event );
+
+    cmdBuffer.clear();
+    for ( int i = 0; i < cmdList.count(); i++ )
+        cmdBuffer += cmdList[i];
 }
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2ClickPointMachine::transition(
-    const QwtEventPattern& eventPattern, const QEvent* event )
+/*!
+   \brief Transition for a classified event
+
+   Observers like QwtPicker2 classify mouse button and key events once
+   into a bitmask of the matching pattern codes: bit i is set, when the
+   event matches QwtEventPattern::MousePatternCode i for mouse buttons
+   or QwtEventPattern::KeyPatternCode i for keys. A mask of -1 indicates,
+   that the event has not been classified - f.e. because the observer
+   relies on reimplementations of QwtEventPattern::mouseMatch().
+
+   The default implementation ignores the mask and calls
+   transition( const QwtEventPattern&, const QEvent*, CommandBuffer& ).
+
+   \param eventPattern Event pattern
+   \param event Event
+   \param patternMask Matching pattern codes, or -1 when
+                      the event has not been classified
+   \param cmdBuffer Buffer for the resulting commands
+
+   \sa QwtPicker2::mousePatternMask(), QwtPicker2::keyPatternMask()
+ */
+void QwtPicker2Machine::transition( const QwtEventPattern& eventPattern,
+    const QEvent* event, int patternMask, CommandBuffer& cmdBuffer )
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    Q_UNUSED( patternMask );
+    transition( eventPattern, event, cmdBuffer );
+}
 
-    switch ( event->type() )
-    {
-        case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                cmdList += Begin;
-                cmdList += Append;
-                cmdList += End;
-            }
-            break;
-        }
-        case QEvent::KeyPress:
-        {
-            const QKeyEvent* keyEvent = static_cast< const QKeyEvent* > ( event );
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1, keyEvent ) )
-            {
-                if ( !keyEvent->isAutoRepeat() )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += End;
-                }
-            }
-            break;
-        }
-        default:
-            break;
-    }
+namespace
+{
+    typedef QwtPicker2TableMachine Machine;
 
-    return cmdList;
+    enum
+    {
+        Begin = QwtPicker2Machine::Begin,
+        Append = QwtPicker2Machine::Append,
+        Move = QwtPicker2Machine::Move,
+        Remove = QwtPicker2Machine::Remove,
+        End = QwtPicker2Machine::End
+    };
+
+    enum
+    {
+        NoOption = Machine::NoOption,
+        IgnoreAutoRepeat = Machine::IgnoreAutoRepeat,
+
+        AnyState = Machine::AnyState,
+        KeepState = Machine::KeepState,
+        AnyPattern = Machine::AnyPattern,
+
+        MouseSelect2 = QwtEventPattern::MouseSelect2,
+        KeySelect1 = QwtEventPattern::KeySelect1,
+        KeySelect2 = QwtEventPattern::KeySelect2,
+
+        OnMousePress = Machine::MousePressEvent,
+        OnMouseRelease = Machine::MouseReleaseEvent,
+        OnMouseMove = Machine::MouseMoveEvent,
+        OnWheel = Machine::WheelEvent,
+        OnKeyPress = Machine::KeyPressEvent,
+        OnEnter = Machine::EnterEvent,
+        OnLeave = Machine::LeaveEvent
+    };
 }
 
-//! Constructor
-QwtPicker2DragPointMachine::QwtPicker2DragPointMachine():
-    QwtPicker2Machine( PointSelection )
+#define QWT_TABLE_SIZE( table ) int( sizeof( table ) / sizeof( table[0] ) )
+
+static const Machine::Transition qwtTrackerTable[] =
 {
-}
+    { 0, OnEnter | OnMouseMove, AnyPattern, NoOption,
+        Machine::Commands< Begin, Append >::Value, 1 },
+    { 1, OnEnter | OnMouseMove, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { AnyState, OnLeave, AnyPattern, NoOption,
+        Machine::Commands< Remove, End >::Value, 0 }
+};
+
+static const Machine::Transition qwtClickPointTable[] =
+{
+    { AnyState, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append, End >::Value, KeepState },
+    { AnyState, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Begin, Append, End >::Value, KeepState }
+};
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2DragPointMachine::transition(
-    const QwtEventPattern& eventPattern, const QEvent* event )
+static const Machine::Transition qwtDragPointTable[] =
+{
+    { 0, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append >::Value, 1 },
+    { 1, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 1, OnMouseRelease, AnyPattern, NoOption,
+        Machine::Commands< End >::Value, 0 },
+    { 0, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Begin, Append >::Value, 1 },
+    { 1, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< End >::Value, 0 }
+};
+
+static const Machine::Transition qwtClickRectTable[] =
+{
+    { 0, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append >::Value, 1 },
+    // state 1: strange, we missed the MouseButtonRelease
+    { 2, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< End >::Value, 0 },
+    { 1, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 2, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 1, OnMouseRelease, MouseSelect2, NoOption,
+        Machine::Commands< Append >::Value, 2 },
+    { 0, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Begin, Append >::Value, 1 },
+    { 1, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Append >::Value, 2 },
+    { 2, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< End >::Value, 0 }
+};
+
+static const Machine::Transition qwtDragRectTable[] =
+{
+    { 0, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append, Append >::Value, 2 },
+    { 2, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 2, OnMouseRelease, AnyPattern, NoOption,
+        Machine::Commands< End >::Value, 0 },
+    { 0, OnKeyPress, KeySelect1, NoOption,
+        Machine::Commands< Begin, Append, Append >::Value, 2 },
+    { 2, OnKeyPress, KeySelect1, NoOption,
+        Machine::Commands< End >::Value, 0 }
+};
+
+static const Machine::Transition qwtPolygonTable[] =
+{
+    { 0, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append, Append, End >::Value, 0 },
+    { 1, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Append, End >::Value, 0 },
+    { 1, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 0, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Begin, Append, Append >::Value, 1 },
+    { 1, OnKeyPress, KeySelect1, IgnoreAutoRepeat,
+        Machine::Commands< Append >::Value, KeepState },
+    { 1, OnKeyPress, KeySelect2, IgnoreAutoRepeat,
+        Machine::Commands< End >::Value, 0 }
+};
+
+static const Machine::Transition qwtDragLineTable[] =
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    { 0, OnMousePress, MouseSelect2, NoOption,
+        Machine::Commands< Begin, Append, Append >::Value, 1 },
+    { 0, OnKeyPress, KeySelect1, NoOption,
+        Machine::Commands< Begin, Append, Append >::Value, 1 },
+    { 1, OnKeyPress, KeySelect1, NoOption,
+        Machine::Commands< End >::Value, 0 },
+    { 1, OnMouseMove | OnWheel, AnyPattern, NoOption,
+        Machine::Commands< Move >::Value, KeepState },
+    { 1, OnMouseRelease, AnyPattern, NoOption,
+        Machine::Commands< End >::Value, 0 }
+};
+
+static inline int qwtEventIndex( QEvent::Type type )
+{
+    // bit position of the corresponding QwtPicker2TableMachine::EventType
 
-    switch ( event->type() )
+    switch ( type )
     {
         case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    setState( 1 );
-                }
-            }
-            break;
-        }
+            return 0;
+        case QEvent::MouseButtonRelease:
+            return 1;
+        case QEvent::MouseButtonDblClick:
+            return 2;
         case QEvent::MouseMove:
+            return 3;
         case QEvent::Wheel:
-        {
-            if ( state() != 0 )
-                cmdList += Move;
-            break;
-        }
-        case QEvent::MouseButtonRelease:
-        {
-            if ( state() != 0 )
-            {
-                cmdList += End;
-                setState( 0 );
-            }
-            break;
-        }
+            return 4;
         case QEvent::KeyPress:
-        {
-            const QKeyEvent* keyEvent = static_cast< const QKeyEvent* > ( event );
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1, keyEvent ) )
-            {
-                if ( !keyEvent->isAutoRepeat() )
-                {
-                    if ( state() == 0 )
-                    {
-                        cmdList += Begin;
-                        cmdList += Append;
-                        setState( 1 );
-                    }
-                    else
-                    {
-                        cmdList += End;
-                        setState( 0 );
-                    }
-                }
-            }
-            break;
-        }
+            return 5;
+        case QEvent::KeyRelease:
+            return 6;
+        case QEvent::Enter:
+            return 7;
+        case QEvent::Leave:
+            return 8;
         default:
-            break;
+            return -1;
     }
-
-    return cmdList;
 }
 
-//! Constructor
-QwtPicker2ClickRectMachine::QwtPicker2ClickRectMachine():
-    QwtPicker2Machine( RectSelection )
-{
-}
+static const int qwtEventIndexCount = 9;
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2ClickRectMachine::transition(
-    const QwtEventPattern& eventPattern, const QEvent* event )
+static bool qwtMatches( const QwtPicker2TableMachine::Transition& transition,
+    const QwtEventPattern& eventPattern, const QEvent* event, int patternMask )
 {
-    QList< QwtPicker2Machine::Command > cmdList;
-
+    // patternMask < 0: the event has not been classified
     switch ( event->type() )
     {
         case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                switch ( state() )
-                {
-                    case 0:
-                    {
-                        cmdList += Begin;
-                        cmdList += Append;
-                        setState( 1 );
-                        break;
-                    }
-                    case 1:
-                    {
-                        // Uh, strange we missed the MouseButtonRelease
-                        break;
-                    }
-                    default:
-                    {
-                        cmdList += End;
-                        setState( 0 );
-                    }
-                }
-            }
-            break;
-        }
-        case QEvent::MouseMove:
-        case QEvent::Wheel:
-        {
-            if ( state() != 0 )
-                cmdList += Move;
-            break;
-        }
         case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
         {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 1 )
-                {
-                    cmdList += Append;
-                    setState( 2 );
-                }
-            }
-            break;
+            if ( transition.pattern == Machine::AnyPattern )
+                return true;
+
+            if ( patternMask >= 0 )
+                return ( patternMask & ( 1 << transition.pattern ) ) != 0;
+
+            return eventPattern.mouseMatch(
+                static_cast< QwtEventPattern::MousePatternCode >( transition.pattern ),
+                static_cast< const QMouseEvent* >( event ) );
         }
         case QEvent::KeyPress:
+        case QEvent::KeyRelease:
         {
-            const QKeyEvent* keyEvent = static_cast< const QKeyEvent* > ( event );
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1, keyEvent ) )
+            const QKeyEvent* keyEvent = static_cast< const QKeyEvent* >( event );
+
+            if ( ( transition.options & Machine::IgnoreAutoRepeat )
+                && keyEvent->isAutoRepeat() )
             {
-                if ( !keyEvent->isAutoRepeat() )
-                {
-                    if ( state() == 0 )
-                    {
-                        cmdList += Begin;
-                        cmdList += Append;
-                        setState( 1 );
-                    }
-                    else
-                    {
-                        if ( state() == 1 )
-                        {
-                            cmdList += Append;
-                            setState( 2 );
-                        }
-                        else if ( state() == 2 )
-                        {
-                            cmdList += End;
-                            setState( 0 );
-                        }
-                    }
-                }
+                return false;
             }
-            break;
+
+            if ( transition.pattern == Machine::AnyPattern )
+                return true;
+
+            if ( patternMask >= 0 )
+                return ( patternMask & ( 1 << transition.pattern ) ) != 0;
+
+            return eventPattern.keyMatch(
+                static_cast< QwtEventPattern::KeyPatternCode >( transition.pattern ),
+                keyEvent );
         }
         default:
-            break;
+            return true;
     }
-
-    return cmdList;
 }
 
-//! Constructor
-QwtPicker2DragRectMachine::QwtPicker2DragRectMachine():
-    QwtPicker2Machine( RectSelection )
+class QwtPicker2TableMachine::PrivateData
 {
-}
-
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2DragRectMachine::transition(
-    const QwtEventPattern& eventPattern, const QEvent* event )
+  public:
+    int stateCount;
+
+    // transitions ordered by state and event type
+    QVector< Transition > transitions;
+
+    // transitions[ offsets[i] ] - transitions[ offsets[i + 1] - 1 ]
+    // are the candidates for state i / qwtEventIndexCount and
+    // event index i % qwtEventIndexCount
+    QVector< int > offsets;
+};
+
+/*!
+   Constructor
+
+   \param type Selection type
+   \param table Table of transitions
+   \param count Number of transitions in table
+
+   \note The table is copied and indexed. For each state and type of event
+         the transitions are checked in the order of the table.
+ */
+QwtPicker2TableMachine::QwtPicker2TableMachine(
+        SelectionType type, const Transition* table, int count )
+    : QwtPicker2Machine( type )
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    m_data = new PrivateData;
 
-    switch ( event->type() )
+    int maxState = 0;
+    for ( int i = 0; i < count; i++ )
     {
-        case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += Append;
-                    setState( 2 );
-                }
-            }
-            break;
-        }
-        case QEvent::MouseMove:
-        case QEvent::Wheel:
-        {
-            if ( state() != 0 )
-                cmdList += Move;
-            break;
-        }
-        case QEvent::MouseButtonRelease:
-        {
-            if ( state() == 2 )
-            {
-                cmdList += End;
-                setState( 0 );
-            }
-            break;
-        }
-        case QEvent::KeyPress:
+        maxState = qMax( maxState, table[i].state );
+        maxState = qMax( maxState, table[i].nextState );
+    }
+
+    m_data->stateCount = maxState + 1;
+
+    const int slotCount = m_data->stateCount * qwtEventIndexCount;
+    m_data->offsets.resize( slotCount + 1 );
+
+    for ( int slot = 0; slot < slotCount; slot++ )
+    {
+        const int state = slot / qwtEventIndexCount;
+        const int eventType = 1 << ( slot % qwtEventIndexCount );
+
+        m_data->offsets[slot] = m_data->transitions.size();
+
+        for ( int i = 0; i < count; i++ )
         {
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1,
-                static_cast< const QKeyEvent* > ( event ) ) )
+            const Transition& transition = table[i];
+
+            if ( ( transition.state == AnyState || transition.state == state )
+                && ( transition.events & eventType ) )
             {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += Append;
-                    setState( 2 );
-                }
-                else
-                {
-                    cmdList += End;
-                    setState( 0 );
-                }
+                m_data->transitions += transition;
             }
-            break;
         }
-        default:
-            break;
     }
 
-    return cmdList;
+    m_data->offsets[slotCount] = m_data->transitions.size();
 }
 
-//! Constructor
-QwtPicker2PolygonMachine::QwtPicker2PolygonMachine():
-    QwtPicker2Machine( PolygonSelection )
+//! Destructor
+QwtPicker2TableMachine::~QwtPicker2TableMachine()
 {
+    delete m_data;
 }
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2PolygonMachine::transition(
+/*!
+   \brief Transition
+
+   Compatibility wrapper, that returns the commands
+   of the table in a list.
+
+   \param eventPattern Event pattern
+   \param event Event
+   \return Commands to be executed
+ */
+QList< QwtPicker2Machine::Command > QwtPicker2TableMachine::transition(
     const QwtEventPattern& eventPattern, const QEvent* event )
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    CommandBuffer cmdBuffer;
+    transition( eventPattern, event, cmdBuffer );
 
-    switch ( event->type() )
-    {
-        case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += Append;
-                    setState( 1 );
-                }
-                else
-                {
-                    cmdList += Append;
-                }
-            }
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 1 )
-                {
-                    cmdList += End;
-                    setState( 0 );
-                }
-            }
-            break;
-        }
-        case QEvent::MouseMove:
-        case QEvent::Wheel:
-        {
-            if ( state() != 0 )
-                cmdList += Move;
-            break;
-        }
-        case QEvent::KeyPress:
-        {
-            const QKeyEvent* keyEvent = static_cast< const QKeyEvent* > ( event );
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1, keyEvent ) )
-            {
-                if ( !keyEvent->isAutoRepeat() )
-                {
-                    if ( state() == 0 )
-                    {
-                        cmdList += Begin;
-                        cmdList += Append;
-                        cmdList += Append;
-                        setState( 1 );
-                    }
-                    else
-                    {
-                        cmdList += Append;
-                    }
-                }
-            }
-            else if ( eventPattern.keyMatch( QwtEventPattern::KeySelect2, keyEvent ) )
-            {
-                if ( !keyEvent->isAutoRepeat() )
-                {
-                    if ( state() == 1 )
-                    {
-                        cmdList += End;
-                        setState( 0 );
-                    }
-                }
-            }
-            break;
-        }
-        default:
-            break;
-    }
+    QList< Command > cmdList;
+    for ( int i = 0; i < cmdBuffer.count(); i++ )
+        cmdList += cmdBuffer[i];
 
     return cmdList;
 }
 
-//! Constructor
-QwtPicker2DragLineMachine::QwtPicker2DragLineMachine():
-    QwtPicker2Machine( PolygonSelection )
+/*!
+   \brief Transition
+
+   Executes the first transition of the table, that matches
+   the current state and the event.
+
+   \param eventPattern Event pattern
+   \param event Event
+   \param cmdList Buffer for the resulting commands
+ */
+void QwtPicker2TableMachine::transition( const QwtEventPattern& eventPattern,
+    const QEvent* event, CommandBuffer& cmdList )
 {
+    transition( eventPattern, event, -1, cmdList );
 }
 
-//! Transition
-QList< QwtPicker2Machine::Command > QwtPicker2DragLineMachine::transition(
-    const QwtEventPattern& eventPattern, const QEvent* event )
+/*!
+   \brief Transition for a classified event
+
+   Executes the first transition of the table, that matches
+   the current state and the event. The patterns of the transitions
+   are checked against patternMask. Only for unclassified events
+   QwtEventPattern::mouseMatch() or QwtEventPattern::keyMatch()
+   are called.
+
+   \param eventPattern Event pattern
+   \param event Event
+   \param patternMask Matching pattern codes, or -1 when
+                      the event has not been classified
+   \param cmdList Buffer for the resulting commands
+ */
+void QwtPicker2TableMachine::transition( const QwtEventPattern& eventPattern,
+    const QEvent* event, int patternMask, CommandBuffer& cmdList )
 {
-    QList< QwtPicker2Machine::Command > cmdList;
+    cmdList.clear();
+
+    const int eventIndex = qwtEventIndex( event->type() );
+    if ( eventIndex < 0 || state() < 0 || state() >= m_data->stateCount )
+        return;
 
-    switch( event->type() )
+    const int slot = state() * qwtEventIndexCount + eventIndex;
+
+    for ( int i = m_data->offsets[slot]; i < m_data->offsets[slot + 1]; i++ )
     {
-        case QEvent::MouseButtonPress:
-        {
-            if ( eventPattern.mouseMatch( QwtEventPattern::MouseSelect2,
-                static_cast< const QMouseEvent* >( event ) ) )
-            {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += Append;
-                    setState( 1 );
-                }
-            }
-            break;
-        }
-        case QEvent::KeyPress:
-        {
-            if ( eventPattern.keyMatch( QwtEventPattern::KeySelect1,
-                static_cast< const QKeyEvent* > ( event ) ) )
-            {
-                if ( state() == 0 )
-                {
-                    cmdList += Begin;
-                    cmdList += Append;
-                    cmdList += Append;
-                    setState( 1 );
-                }
-                else
-                {
-                    cmdList += End;
-                    setState( 0 );
-                }
-            }
-            break;
-        }
-        case QEvent::MouseMove:
-        case QEvent::Wheel:
-        {
-            if ( state() != 0 )
-                cmdList += Move;
+        const Transition& transition = m_data->transitions[i];
 
-            break;
-        }
-        case QEvent::MouseButtonRelease:
+        if ( qwtMatches( transition, eventPattern, event, patternMask ) )
         {
-            if ( state() != 0 )
+            for ( int commands = transition.commands;
+                commands != 0; commands >>= 3 )
             {
-                cmdList += End;
-                setState( 0 );
+                cmdList += static_cast< Command >( ( commands & 0x07 ) - 1 );
             }
+
+            if ( transition.nextState != KeepState )
+                setState( transition.nextState );
+
+            return;
         }
-        default:
-            break;
     }
+}
 
-    return cmdList;
+/*!
+   \brief Check if an event might result in a transition
+
+   \param eventType QEvent::Type
+   \return true, when the table has a transition for the current
+           state and the type of event
+ */
+bool QwtPicker2TableMachine::acceptsEvent( int eventType ) const
+{
+    const int eventIndex = qwtEventIndex( static_cast< QEvent::Type >( eventType ) );
+    if ( eventIndex < 0 || state() < 0 || state() >= m_data->stateCount )
+        return false;
+
+    const int slot = state() * qwtEventIndexCount + eventIndex;
+    return m_data->offsets[slot] < m_data->offsets[slot + 1];
+}
+
+//! Constructor
+QwtPicker2TrackerMachine::QwtPicker2TrackerMachine():
+    QwtPicker2TableMachine( NoSelection,
+        qwtTrackerTable, QWT_TABLE_SIZE( qwtTrackerTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2ClickPointMachine::QwtPicker2ClickPointMachine():
+    QwtPicker2TableMachine( PointSelection,
+        qwtClickPointTable, QWT_TABLE_SIZE( qwtClickPointTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2DragPointMachine::QwtPicker2DragPointMachine():
+    QwtPicker2TableMachine( PointSelection,
+        qwtDragPointTable, QWT_TABLE_SIZE( qwtDragPointTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2ClickRectMachine::QwtPicker2ClickRectMachine():
+    QwtPicker2TableMachine( RectSelection,
+        qwtClickRectTable, QWT_TABLE_SIZE( qwtClickRectTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2DragRectMachine::QwtPicker2DragRectMachine():
+    QwtPicker2TableMachine( RectSelection,
+        qwtDragRectTable, QWT_TABLE_SIZE( qwtDragRectTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2PolygonMachine::QwtPicker2PolygonMachine():
+    QwtPicker2TableMachine( PolygonSelection,
+        qwtPolygonTable, QWT_TABLE_SIZE( qwtPolygonTable ) )
+{
+    setBufferDispatch( true );
+}
+
+//! Constructor
+QwtPicker2DragLineMachine::QwtPicker2DragLineMachine():
+    QwtPicker2TableMachine( PolygonSelection,
+        qwtDragLineTable, QWT_TABLE_SIZE( qwtDragLineTable ) )
+{
+    setBufferDispatch( true );
 }
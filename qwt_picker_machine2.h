@@ -57,12 +57,54 @@ class QWT_EXPORT QwtPicker2Machine
         End
     };
 
+    /*!
+       \brief A list of commands with a fixed capacity
+
+       CommandBuffer stores the commands of a transition without
+       any heap allocation. None of the predefined state machines
+       emits more than 5 commands for an event.
+     */
+    class CommandBuffer
+    {
+      public:
+        //! Maximum number of commands
+        enum { Capacity = 8 };
+
+        CommandBuffer();
+
+        void clear();
+
+        void append( Command );
+        CommandBuffer& operator+=( Command );
+
+        int count() const;
+        bool isEmpty() const;
+
+        Command operator[]( int index ) const;
+
+      private:
+        Command m_commands[ Capacity ];
+        int m_count;
+    };
+
     explicit QwtPicker2Machine( SelectionType );
     virtual ~QwtPicker2Machine();
 
     //! Transition
     virtual QList< Command > transition(
         const QwtEventPattern&, const QEvent* ) = 0;
+
+    virtual void transition( const QwtEventPattern&,
+        const QEvent*, CommandBuffer& );
+
+    virtual void transition( const QwtEventPattern&,
+        const QEvent*, int patternMask, CommandBuffer& );
+
+    virtual bool acceptsEvent( int eventType ) const;
+
+    void dispatch( const QwtEventPattern&,
+        const QEvent*, int patternMask, CommandBuffer& );
+
     void reset();
 
     int state() const;
@@ -70,9 +112,174 @@ class QWT_EXPORT QwtPicker2Machine
 
     SelectionType selectionType() const;
 
+    bool bufferDispatch() const;
+
+  protected:
+    void setBufferDispatch( bool );
+
   private:
     const SelectionType m_selectionType;
     int m_state;
+    bool m_bufferDispatch;
+};
+
+/*!
+   \brief A state machine, that is defined by a table of transitions
+
+   Each transition of the table maps a state, a set of event types and
+   an optional event pattern into a sequence of commands and a new state.
+   For an event the first matching transition of the current state
+   is executed.
+
+   The table is indexed by state and event type, when the machine is
+   constructed. So the costs of a transition do not depend on the size
+   of the table.
+
+   All predefined state machines are defined by transition tables.
+   The following example implements a machine for selecting a point
+   with the left mouse button:
+
+   \code
+    typedef QwtPicker2TableMachine Machine;
+
+    static const Machine::Transition table[] =
+    {
+        { 0, Machine::MousePressEvent, QwtEventPattern::MouseSelect1,
+            Machine::NoOption, Machine::Commands< Machine::Begin,
+            Machine::Append >::Value, 1 },
+        { 1, Machine::MouseMoveEvent, Machine::AnyPattern,
+            Machine::NoOption, Machine::Commands< Machine::Move >::Value,
+            Machine::KeepState },
+        { 1, Machine::MouseReleaseEvent, QwtEventPattern::MouseSelect1,
+            Machine::NoOption, Machine::Commands< Machine::End >::Value, 0 }
+    };
+
+    picker->setStateMachine( new Machine( QwtPicker2Machine::PointSelection,
+        table, sizeof( table ) / sizeof( table[0] ) ) );
+   \endcode
+ */
+class QWT_EXPORT QwtPicker2TableMachine : public QwtPicker2Machine
+{
+  public:
+    /*!
+       Event types, that can be combined in Transition::events
+     */
+    enum EventType
+    {
+        //! QEvent::MouseButtonPress
+        MousePressEvent = 0x0001,
+
+        //! QEvent::MouseButtonRelease
+        MouseReleaseEvent = 0x0002,
+
+        //! QEvent::MouseButtonDblClick
+        MouseDoubleClickEvent = 0x0004,
+
+        //! QEvent::MouseMove
+        MouseMoveEvent = 0x0008,
+
+        //! QEvent::Wheel
+        WheelEvent = 0x0010,
+
+        //! QEvent::KeyPress
+        KeyPressEvent = 0x0020,
+
+        //! QEvent::KeyRelease
+        KeyReleaseEvent = 0x0040,
+
+        //! QEvent::Enter
+        EnterEvent = 0x0080,
+
+        //! QEvent::Leave
+        LeaveEvent = 0x0100
+    };
+
+    //! Options for a transition
+    enum TransitionOption
+    {
+        //! No option
+        NoOption = 0x00,
+
+        //! The transition doesn't match auto repeated key events
+        IgnoreAutoRepeat = 0x01
+    };
+
+    enum
+    {
+        //! The transition matches in any state
+        AnyState = -1,
+
+        //! The transition doesn't change the state
+        KeepState = -1,
+
+        //! The transition matches without checking an event pattern
+        AnyPattern = -1
+    };
+
+    /*!
+       \brief An entry of the transition table
+     */
+    struct Transition
+    {
+        //! State, where the transition matches, or AnyState
+        int state;
+
+        //! Combination of EventType flags
+        int events;
+
+        /*!
+           QwtEventPattern::MousePatternCode for mouse button events,
+           QwtEventPattern::KeyPatternCode for key events or AnyPattern.
+           The pattern is not checked for other types of events.
+         */
+        int pattern;
+
+        //! Combination of TransitionOption flags
+        int options;
+
+        //! Sequence of commands, encoded by Commands<>::Value
+        int commands;
+
+        //! State after the transition, or KeepState
+        int nextState;
+    };
+
+    /*!
+       \brief Encoding of a sequence of up to 5 commands
+
+       The sequence is encoded at compile time into an integer,
+       that can be used for Transition::commands.
+     */
+    template< int c1 = -1, int c2 = -1, int c3 = -1, int c4 = -1, int c5 = -1 >
+    struct Commands
+    {
+        enum
+        {
+            //! Encoded commands
+            Value = ( c1 + 1 ) | ( ( c2 + 1 ) << 3 ) | ( ( c3 + 1 ) << 6 )
+                | ( ( c4 + 1 ) << 9 ) | ( ( c5 + 1 ) << 12 )
+        };
+    };
+
+    QwtPicker2TableMachine( SelectionType,
+        const Transition* table, int count );
+
+    virtual ~QwtPicker2TableMachine();
+
+    virtual QList< Command > transition(
+        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
+
+    virtual void transition( const QwtEventPattern&,
+        const QEvent*, CommandBuffer& ) QWT_OVERRIDE;
+
+    virtual void transition( const QwtEventPattern&,
+        const QEvent*, int patternMask, CommandBuffer& ) QWT_OVERRIDE;
+
+    virtual bool acceptsEvent( int eventType ) const QWT_OVERRIDE;
+
+  private:
+    class PrivateData;
+    PrivateData* m_data;
 };
 
 /*!
@@ -82,13 +289,10 @@ class QWT_EXPORT QwtPicker2Machine
    corresponding to mouse movements, but is not intended for
    selecting anything. Begin/End are related to Enter/Leave events.
  */
-class QWT_EXPORT QwtPicker2TrackerMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2TrackerMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2TrackerMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -99,13 +303,10 @@ class QWT_EXPORT QwtPicker2TrackerMachine : public QwtPicker2Machine
 
    \sa QwtEventPattern::MousePatternCode, QwtEventPattern::KeyPatternCode
  */
-class QWT_EXPORT QwtPicker2ClickPointMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2ClickPointMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2ClickPointMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -115,13 +316,10 @@ class QWT_EXPORT QwtPicker2ClickPointMachine : public QwtPicker2Machine
    starts the selection, releasing QwtEventPattern::MouseSelect1 or
    a second press of QwtEventPattern::KeySelect1 terminates it.
  */
-class QWT_EXPORT QwtPicker2DragPointMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2DragPointMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2DragPointMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -137,13 +335,10 @@ class QWT_EXPORT QwtPicker2DragPointMachine : public QwtPicker2Machine
    \sa QwtEventPattern::MousePatternCode, QwtEventPattern::KeyPatternCode
  */
 
-class QWT_EXPORT QwtPicker2ClickRectMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2ClickRectMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2ClickRectMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -158,13 +353,10 @@ class QWT_EXPORT QwtPicker2ClickRectMachine : public QwtPicker2Machine
    \sa QwtEventPattern::MousePatternCode, QwtEventPattern::KeyPatternCode
  */
 
-class QWT_EXPORT QwtPicker2DragRectMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2DragRectMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2DragRectMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -182,13 +374,10 @@ class QWT_EXPORT QwtPicker2DragRectMachine : public QwtPicker2Machine
    \sa QwtEventPattern::MousePatternCode, QwtEventPattern::KeyPatternCode
  */
 
-class QWT_EXPORT QwtPicker2DragLineMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2DragLineMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2DragLineMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
 /*!
@@ -202,13 +391,58 @@ class QWT_EXPORT QwtPicker2DragLineMachine : public QwtPicker2Machine
    \sa QwtEventPattern::MousePatternCode, QwtEventPattern::KeyPatternCode
  */
 
-class QWT_EXPORT QwtPicker2PolygonMachine : public QwtPicker2Machine
+class QWT_EXPORT QwtPicker2PolygonMachine : public QwtPicker2TableMachine
 {
   public:
     QwtPicker2PolygonMachine();
-
-    virtual QList< Command > transition(
-        const QwtEventPattern&, const QEvent* ) QWT_OVERRIDE;
 };
 
+//! Constructor
+inline QwtPicker2Machine::CommandBuffer::CommandBuffer():
+    m_count( 0 )
+{
+}
+
+//! Remove all commands
+inline void QwtPicker2Machine::CommandBuffer::clear()
+{
+    m_count = 0;
+}
+
+//! Append a command, commands exceeding the capacity are ignored
+inline void QwtPicker2Machine::CommandBuffer::append( Command command )
+{
+    Q_ASSERT( m_count < Capacity );
+
+    if ( m_count < Capacity )
+        m_commands[ m_count++ ] = command;
+}
+
+//! Append a command
+inline QwtPicker2Machine::CommandBuffer&
+QwtPicker2Machine::CommandBuffer::operator+=( Command command )
+{
+    append( command );
+    return *this;
+}
+
+//! \return Number of commands
+inline int QwtPicker2Machine::CommandBuffer::count() const
+{
+    return m_count;
+}
+
+//! \return True, when the buffer contains no commands
+inline bool QwtPicker2Machine::CommandBuffer::isEmpty() const
+{
+    return m_count == 0;
+}
+
+//! \return Command at position index
+inline QwtPicker2Machine::Command
+QwtPicker2Machine::CommandBuffer::operator[]( int index ) const
+{
+    return m_commands[ index ];
+}
+
 #endif
@@ -0,0 +1,647 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_picker_recorder2.h"
+#include "qwt_picker2.h"
+
+#include <qevent.h>
+#include <qwidget.h>
+#include <qpointer.h>
+#include <qvector.h>
+#include <qdatastream.h>
+#include <qelapsedtimer.h>
+#include <qbasictimer.h>
+#include <qcoreapplication.h>
+
+namespace
+{
+    // "QPR2"
+    const quint32 qwtLogMagic = 0x51505232;
+    const quint16 qwtLogVersion = 1;
+
+    /*
+        An event of the log. Depending on the type only some of
+        the members are used:
+
+        - mouse events: pos, button, buttons, modifiers
+        - wheel events: pos, delta, buttons, modifiers
+        - key events: key ( in button ), modifiers, autoRepeat, text
+        - enter events: pos
+        - resize events: size ( in pos )
+     */
+    class Record
+    {
+      public:
+        Record()
+            : time( 0 )
+            , type( 0 )
+            , button( 0 )
+            , buttons( 0 )
+            , modifiers( 0 )
+            , autoRepeat( false )
+        {
+        }
+
+        quint32 time; // ms since the start of the recording
+        quint16 type; // QEvent::Type
+
+        QPoint pos;
+        QPoint delta;
+
+        quint32 button;
+        quint32 buttons;
+        quint32 modifiers;
+
+        bool autoRepeat;
+        QString text;
+    };
+}
+
+static QDataStream& operator<<( QDataStream& stream, const Record& record )
+{
+    stream << record.time << record.type;
+
+    switch ( record.type )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            stream << record.pos << record.button
+                << record.buttons << record.modifiers;
+            break;
+        }
+        case QEvent::Wheel:
+        {
+            stream << record.pos << record.delta
+                << record.buttons << record.modifiers;
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            stream << record.button << record.modifiers
+                << quint8( record.autoRepeat ) << record.text;
+            break;
+        }
+        case QEvent::Enter:
+        case QEvent::Resize:
+        {
+            stream << record.pos;
+            break;
+        }
+        default:
+            break;
+    }
+
+    return stream;
+}
+
+static QDataStream& operator>>( QDataStream& stream, Record& record )
+{
+    stream >> record.time >> record.type;
+
+    switch ( record.type )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            stream >> record.pos >> record.button
+                >> record.buttons >> record.modifiers;
+            break;
+        }
+        case QEvent::Wheel:
+        {
+            stream >> record.pos >> record.delta
+                >> record.buttons >> record.modifiers;
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            quint8 autoRepeat;
+
+            stream >> record.button >> record.modifiers
+                >> autoRepeat >> record.text;
+
+            record.autoRepeat = ( autoRepeat != 0 );
+            break;
+        }
+        case QEvent::Enter:
+        case QEvent::Resize:
+        {
+            stream >> record.pos;
+            break;
+        }
+        default:
+            break;
+    }
+
+    return stream;
+}
+
+static bool qwtToRecord( const QEvent* event, Record& record )
+{
+    record.type = event->type();
+
+    switch ( event->type() )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            const QMouseEvent* me = static_cast< const QMouseEvent* >( event );
+
+            record.pos = me->pos();
+            record.button = me->button();
+            record.buttons = int( me->buttons() );
+            record.modifiers = int( me->modifiers() );
+            return true;
+        }
+        case QEvent::Wheel:
+        {
+            const QWheelEvent* we = static_cast< const QWheelEvent* >( event );
+
+#if QT_VERSION < 0x050e00
+            record.pos = we->pos();
+#else
+            record.pos = we->position().toPoint();
+#endif
+
+#if QT_VERSION >= 0x050000
+            record.delta = we->angleDelta();
+#else
+            if ( we->orientation() == Qt::Horizontal )
+                record.delta = QPoint( we->delta(), 0 );
+            else
+                record.delta = QPoint( 0, we->delta() );
+#endif
+            record.buttons = int( we->buttons() );
+            record.modifiers = int( we->modifiers() );
+            return true;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            const QKeyEvent* ke = static_cast< const QKeyEvent* >( event );
+
+            record.button = ke->key();
+            record.modifiers = int( ke->modifiers() );
+            record.autoRepeat = ke->isAutoRepeat();
+            record.text = ke->text();
+            return true;
+        }
+        case QEvent::Enter:
+        {
+#if QT_VERSION >= 0x060000
+            record.pos = static_cast< const QEnterEvent* >( event )->position().toPoint();
+#elif QT_VERSION >= 0x050000
+            record.pos = static_cast< const QEnterEvent* >( event )->pos();
+#endif
+            return true;
+        }
+        case QEvent::Leave:
+        {
+            return true;
+        }
+        case QEvent::Resize:
+        {
+            const QSize size = static_cast< const QResizeEvent* >( event )->size();
+            record.pos = QPoint( size.width(), size.height() );
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+class QwtPicker2Recorder::PrivateData
+{
+  public:
+    PrivateData():
+        isRecording( false ),
+        eventCount( 0 )
+    {
+    }
+
+    QPointer< QwtPicker2 > picker;
+    QPointer< QWidget > widget;
+
+    bool isRecording;
+    int eventCount;
+
+    QDataStream stream;
+    QElapsedTimer elapsedTimer;
+};
+
+/*!
+   Constructor
+
+   \param picker Picker, whose input is recorded
+   \param parent Parent object
+ */
+QwtPicker2Recorder::QwtPicker2Recorder( QwtPicker2* picker, QObject* parent )
+    : QObject( parent )
+{
+    m_data = new PrivateData;
+    m_data->picker = picker;
+}
+
+//! Destructor
+QwtPicker2Recorder::~QwtPicker2Recorder()
+{
+    stop();
+    delete m_data;
+}
+
+//! \return Picker, whose input is recorded
+QwtPicker2* QwtPicker2Recorder::picker()
+{
+    return m_data->picker;
+}
+
+//! \return Picker, whose input is recorded
+const QwtPicker2* QwtPicker2Recorder::picker() const
+{
+    return m_data->picker;
+}
+
+/*!
+   \brief Start a recording
+
+   A header is written to the device and an event filter is
+   installed for the parent widget of the picker. As it is installed
+   after the filter of the picker, it sees the events first.
+
+   \param device Device for the log, opened for writing
+   \return true, when the recording has been started
+
+   \sa stop(), isRecording()
+ */
+bool QwtPicker2Recorder::start( QIODevice* device )
+{
+    stop();
+
+    if ( device == NULL || m_data->picker.isNull()
+        || m_data->picker->parentWidget() == NULL )
+    {
+        return false;
+    }
+
+    m_data->stream.setDevice( device );
+    m_data->stream.setVersion( QDataStream::Qt_4_6 );
+
+    m_data->stream << qwtLogMagic << qwtLogVersion;
+    if ( m_data->stream.status() != QDataStream::Ok )
+    {
+        m_data->stream.setDevice( NULL );
+        return false;
+    }
+
+    m_data->widget = m_data->picker->parentWidget();
+    m_data->widget->installEventFilter( this );
+
+    m_data->eventCount = 0;
+    m_data->isRecording = true;
+    m_data->elapsedTimer.start();
+
+    return true;
+}
+
+/*!
+   Stop the recording
+   \sa start()
+ */
+void QwtPicker2Recorder::stop()
+{
+    if ( !m_data->isRecording )
+        return;
+
+    if ( m_data->widget )
+        m_data->widget->removeEventFilter( this );
+
+    m_data->widget = NULL;
+    m_data->stream.setDevice( NULL );
+    m_data->isRecording = false;
+}
+
+//! \return true, when recording
+bool QwtPicker2Recorder::isRecording() const
+{
+    return m_data->isRecording;
+}
+
+//! \return Number of events, that have been recorded
+int QwtPicker2Recorder::eventCount() const
+{
+    return m_data->eventCount;
+}
+
+/*!
+   Write the events, that are relevant for the picker, to the log
+
+   \param object Object to be filtered
+   \param event Event
+   \return Always false
+ */
+bool QwtPicker2Recorder::eventFilter( QObject* object, QEvent* event )
+{
+    if ( m_data->isRecording && object == m_data->widget )
+    {
+        Record record;
+        if ( qwtToRecord( event, record ) )
+        {
+            record.time = quint32( m_data->elapsedTimer.elapsed() );
+
+            m_data->stream << record;
+            m_data->eventCount++;
+        }
+    }
+
+    return false;
+}
+
+class QwtPicker2Player::PrivateData
+{
+  public:
+    PrivateData():
+        index( -1 )
+    {
+    }
+
+    QPointer< QwtPicker2 > picker;
+    QVector< Record > records;
+
+    int index; // next record to be sent, -1 when not playing
+    QBasicTimer timer;
+    QElapsedTimer elapsedTimer;
+};
+
+/*!
+   Constructor
+
+   \param picker Picker, where to inject the events
+   \param parent Parent object
+ */
+QwtPicker2Player::QwtPicker2Player( QwtPicker2* picker, QObject* parent )
+    : QObject( parent )
+{
+    m_data = new PrivateData;
+    m_data->picker = picker;
+}
+
+//! Destructor
+QwtPicker2Player::~QwtPicker2Player()
+{
+    delete m_data;
+}
+
+//! \return Picker, where to inject the events
+QwtPicker2* QwtPicker2Player::picker()
+{
+    return m_data->picker;
+}
+
+//! \return Picker, where to inject the events
+const QwtPicker2* QwtPicker2Player::picker() const
+{
+    return m_data->picker;
+}
+
+/*!
+   Load a log, that has been written by QwtPicker2Recorder
+
+   \param device Device, opened for reading
+   \return true, when the log could be read completely
+ */
+bool QwtPicker2Player::load( QIODevice* device )
+{
+    stop();
+    m_data->records.clear();
+
+    if ( device == NULL )
+        return false;
+
+    QDataStream stream( device );
+    stream.setVersion( QDataStream::Qt_4_6 );
+
+    quint32 magic;
+    quint16 version;
+
+    stream >> magic >> version;
+    if ( stream.status() != QDataStream::Ok
+        || magic != qwtLogMagic || version != qwtLogVersion )
+    {
+        return false;
+    }
+
+    while ( !stream.atEnd() )
+    {
+        Record record;
+        stream >> record;
+
+        if ( stream.status() != QDataStream::Ok )
+        {
+            m_data->records.clear();
+            return false;
+        }
+
+        m_data->records += record;
+    }
+
+    return true;
+}
+
+//! \return Number of events of the log
+int QwtPicker2Player::eventCount() const
+{
+    return m_data->records.size();
+}
+
+/*!
+   \brief Send the events of the log
+
+   For MaximumSpeed all events are sent before play() returns,
+   otherwise they are sent from the event loop according to
+   the timestamps of the log. finished() is emitted, when
+   all events have been sent.
+
+   \param speed Speed of the replay
+   \sa stop(), isPlaying()
+ */
+void QwtPicker2Player::play( Speed speed )
+{
+    stop();
+
+    if ( speed == MaximumSpeed )
+    {
+        for ( int i = 0; i < m_data->records.size(); i++ )
+            sendEvent( i );
+
+        Q_EMIT finished();
+        return;
+    }
+
+    m_data->index = 0;
+    m_data->elapsedTimer.start();
+    m_data->timer.start( 0, this );
+}
+
+/*!
+   Stop a replay, that has been started with OriginalSpeed
+   \sa play()
+ */
+void QwtPicker2Player::stop()
+{
+    if ( m_data->index >= 0 )
+    {
+        m_data->index = -1;
+        m_data->timer.stop();
+
+        Q_EMIT finished();
+    }
+}
+
+//! \return true, while a replay with OriginalSpeed is running
+bool QwtPicker2Player::isPlaying() const
+{
+    return m_data->index >= 0;
+}
+
+/*!
+   Send the events, that are due, and schedule the next ones
+
+   \param event Timer event
+ */
+void QwtPicker2Player::timerEvent( QTimerEvent* event )
+{
+    if ( event->timerId() != m_data->timer.timerId() )
+    {
+        QObject::timerEvent( event );
+        return;
+    }
+
+    const qint64 elapsed = m_data->elapsedTimer.elapsed();
+
+    while ( m_data->index >= 0 && m_data->index < m_data->records.size()
+        && m_data->records[m_data->index].time <= elapsed )
+    {
+        // the index is incremented first: sendEvent might call stop()
+        sendEvent( m_data->index++ );
+    }
+
+    if ( m_data->index < 0 )
+        return;
+
+    if ( m_data->index >= m_data->records.size() )
+    {
+        stop();
+        return;
+    }
+
+    const qint64 delay = m_data->records[m_data->index].time - elapsed;
+    m_data->timer.start( int( delay ), this );
+}
+
+void QwtPicker2Player::sendEvent( int index )
+{
+    if ( m_data->picker.isNull() )
+        return;
+
+    QWidget* w = m_data->picker->parentWidget();
+    if ( w == NULL )
+        return;
+
+    const Record& record = m_data->records[index];
+
+    const Qt::MouseButtons buttons( QFlag( int( record.buttons ) ) );
+    const Qt::KeyboardModifiers modifiers( QFlag( int( record.modifiers ) ) );
+
+    switch ( record.type )
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            QMouseEvent event( static_cast< QEvent::Type >( record.type ),
+                record.pos, w->mapToGlobal( record.pos ),
+                static_cast< Qt::MouseButton >( record.button ),
+                buttons, modifiers );
+
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::Wheel:
+        {
+            const QPoint globalPos = w->mapToGlobal( record.pos );
+
+#if QT_VERSION >= 0x050c00
+            QWheelEvent event( record.pos, globalPos, QPoint(), record.delta,
+                buttons, modifiers, Qt::NoScrollPhase, false );
+#else
+            const bool isVertical = ( record.delta.y() != 0 )
+                || ( record.delta.x() == 0 );
+
+            const int delta = isVertical ? record.delta.y() : record.delta.x();
+            const Qt::Orientation orientation =
+                isVertical ? Qt::Vertical : Qt::Horizontal;
+
+#if QT_VERSION >= 0x050000
+            QWheelEvent event( record.pos, globalPos, QPoint(), record.delta,
+                delta, orientation, buttons, modifiers );
+#else
+            QWheelEvent event( record.pos, globalPos,
+                delta, buttons, modifiers, orientation );
+#endif
+#endif
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        {
+            QKeyEvent event( static_cast< QEvent::Type >( record.type ),
+                int( record.button ), modifiers, record.text, record.autoRepeat );
+
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::Enter:
+        {
+#if QT_VERSION >= 0x050000
+            QEnterEvent event( record.pos,
+                w->mapTo( w->window(), record.pos ), w->mapToGlobal( record.pos ) );
+#else
+            QEvent event( QEvent::Enter );
+#endif
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::Leave:
+        {
+            QEvent event( QEvent::Leave );
+            QCoreApplication::sendEvent( w, &event );
+            break;
+        }
+        case QEvent::Resize:
+        {
+            w->resize( record.pos.x(), record.pos.y() );
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+#include "moc_qwt_picker_recorder2.cpp"
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PICKER_RECORDER2_H
+#define QWT_PICKER_RECORDER2_H
+
+#include "qwt_global.h"
+#include <qobject.h>
+
+class QwtPicker2;
+class QIODevice;
+class QTimerEvent;
+
+/*!
+   \brief A recorder for the input of a picker
+
+   QwtPicker2Recorder writes the events, that are filtered by
+   a QwtPicker2, into a compact binary log: for each event its type,
+   position, buttons, modifiers, key and the time since the start
+   of the recording.
+
+   The log can be injected into a picker by QwtPicker2Player, to
+   reproduce timing dependent sessions. As the replay produces the
+   same selections, the log can be used as a fixture for performance
+   tests and as oracle for regression tests.
+
+   \code
+    QFile file( "session.log" );
+    file.open( QIODevice::WriteOnly );
+
+    QwtPicker2Recorder recorder( picker );
+    recorder.start( &file );
+    ...
+    recorder.stop();
+   \endcode
+
+   \sa QwtPicker2Player
+ */
+class QWT_EXPORT QwtPicker2Recorder : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit QwtPicker2Recorder( QwtPicker2*, QObject* parent = NULL );
+    virtual ~QwtPicker2Recorder();
+
+    QwtPicker2* picker();
+    const QwtPicker2* picker() const;
+
+    bool start( QIODevice* );
+    void stop();
+
+    bool isRecording() const;
+    int eventCount() const;
+
+    virtual bool eventFilter( QObject*, QEvent* ) QWT_OVERRIDE;
+
+  private:
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+/*!
+   \brief A player for logs of QwtPicker2Recorder
+
+   QwtPicker2Player sends the recorded events to the parent widget
+   of a picker, so that they pass the event filter of the picker
+   like the original ones. Resize events are reproduced by resizing
+   the widget.
+
+   The log can be played with its original timing, or as fast as
+   possible, what is done synchronously in play().
+
+   \sa QwtPicker2Recorder
+ */
+class QWT_EXPORT QwtPicker2Player : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /*!
+       Speed of the replay
+       \sa play()
+     */
+    enum Speed
+    {
+        //! Events are sent with the timing of the recording
+        OriginalSpeed,
+
+        //! Events are sent without delay, synchronously in play()
+        MaximumSpeed
+    };
+
+    explicit QwtPicker2Player( QwtPicker2*, QObject* parent = NULL );
+    virtual ~QwtPicker2Player();
+
+    QwtPicker2* picker();
+    const QwtPicker2* picker() const;
+
+    bool load( QIODevice* );
+    int eventCount() const;
+
+    void play( Speed = OriginalSpeed );
+    void stop();
+
+    bool isPlaying() const;
+
+  Q_SIGNALS:
+    /*!
+       A signal emitted, when all events have been sent
+       or the replay has been stopped.
+     */
+    void finished();
+
+  protected:
+    virtual void timerEvent( QTimerEvent* ) QWT_OVERRIDE;
+
+  private:
+    void sendEvent( int index );
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
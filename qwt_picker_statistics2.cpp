@@ -0,0 +1,142 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_picker_statistics2.h"
+#include <cstring>
+
+//! Constructor
+QwtPicker2Statistics::QwtPicker2Statistics()
+{
+    reset();
+}
+
+//! Clear all counters
+void QwtPicker2Statistics::reset()
+{
+    std::memset( m_phases, 0, sizeof( m_phases ) );
+}
+
+/*!
+   Add a sample
+
+   \param phase Phase
+   \param nsecs Time in nanoseconds
+ */
+void QwtPicker2Statistics::addSample( Phase phase, qint64 nsecs )
+{
+    if ( int( phase ) < 0 || int( phase ) >= PhaseCount )
+        return;
+
+    PhaseData& data = m_phases[phase];
+
+    data.count++;
+    data.total += nsecs;
+
+    if ( nsecs > data.max )
+        data.max = nsecs;
+
+    int bucket = 0;
+    while ( bucket < BucketCount - 1 && nsecs >= bucketLimit( bucket ) )
+        bucket++;
+
+    data.buckets[bucket]++;
+}
+
+/*!
+   \param phase Phase
+   \return Number of samples
+ */
+qint64 QwtPicker2Statistics::count( Phase phase ) const
+{
+    return m_phases[phase].count;
+}
+
+/*!
+   \param phase Phase
+   \return Sum of all samples in nanoseconds
+ */
+qint64 QwtPicker2Statistics::totalTime( Phase phase ) const
+{
+    return m_phases[phase].total;
+}
+
+/*!
+   \param phase Phase
+   \return Maximum of all samples in nanoseconds
+ */
+qint64 QwtPicker2Statistics::maxTime( Phase phase ) const
+{
+    return m_phases[phase].max;
+}
+
+/*!
+   \param phase Phase
+   \return Average of all samples in nanoseconds, 0 without samples
+ */
+qint64 QwtPicker2Statistics::averageTime( Phase phase ) const
+{
+    const PhaseData& data = m_phases[phase];
+    return ( data.count > 0 ) ? data.total / data.count : 0;
+}
+
+/*!
+   \param phase Phase
+   \param bucket Index of the bucket
+   \return Number of samples of a bucket of the histogram
+   \sa bucketLimit()
+ */
+qint64 QwtPicker2Statistics::bucketCount( Phase phase, int bucket ) const
+{
+    if ( bucket < 0 || bucket >= BucketCount )
+        return 0;
+
+    return m_phases[phase].buckets[bucket];
+}
+
+/*!
+   \param bucket Index of the bucket
+   \return Exclusive upper limit of a bucket in nanoseconds,
+           -1 for the last bucket, that has no limit
+ */
+qint64 QwtPicker2Statistics::bucketLimit( int bucket )
+{
+    if ( bucket < 0 || bucket >= BucketCount - 1 )
+        return -1;
+
+    return qint64( 1000 ) << bucket;
+}
+
+/*!
+   \param phase Phase
+   \return Name of the phase, f.e for reports
+ */
+const char* QwtPicker2Statistics::phaseName( Phase phase )
+{
+    switch ( phase )
+    {
+        case EventDispatch:
+            return "eventFilter";
+        case Transition:
+            return "transition";
+        case AdjustedPoints:
+            return "adjustedPoints";
+        case RubberBandMask:
+            return "rubberBandMask";
+        case TrackerMask:
+            return "trackerMask";
+        case TrackerText:
+            return "trackerText";
+        case OverlayPaint:
+            return "overlayPaint";
+        case SignalEmission:
+            return "signalEmission";
+    }
+
+    return "";
+}
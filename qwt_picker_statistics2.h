@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PICKER_STATISTICS2_H
+#define QWT_PICKER_STATISTICS2_H
+
+#include "qwt_global.h"
+#include <qelapsedtimer.h>
+
+/*!
+   \brief Latency statistics of the processing phases of a QwtPicker2
+
+   For each phase the number of samples, the total and the maximum
+   time are counted. The times are also sorted into a histogram with
+   logarithmic buckets: bucket 0 counts the samples below 1us, bucket i
+   the samples below 2^i us. The last bucket counts all samples above
+   the limit of its predecessor.
+
+   The statistics are collected only, when the library has been built
+   with QWT_PICKER2_STATISTICS defined. Otherwise the instrumentation
+   is compiled out and QwtPicker2::statistics() returns NULL.
+
+   Phases might be nested - f.e. painting the rubber band includes
+   adjustedPoints() - and their times are inclusive.
+
+   \sa QwtPicker2::statistics()
+ */
+class QWT_EXPORT QwtPicker2Statistics
+{
+  public:
+    //! Processing phases of a picker
+    enum Phase
+    {
+        //! QwtPicker2::eventFilter()
+        EventDispatch,
+
+        //! QwtPicker2Machine::transition()
+        Transition,
+
+        //! QwtPicker2::adjustedPoints()
+        AdjustedPoints,
+
+        //! QwtPicker2::rubberBandMask()
+        RubberBandMask,
+
+        //! QwtPicker2::trackerMask()
+        TrackerMask,
+
+        //! QwtPicker2::trackerText()
+        TrackerText,
+
+        //! Painting the rubber band or tracker overlay
+        OverlayPaint,
+
+        //! Emitting the signals of the picker
+        SignalEmission
+    };
+
+    enum
+    {
+        //! Number of phases
+        PhaseCount = SignalEmission + 1,
+
+        //! Number of buckets of the histogram of a phase
+        BucketCount = 16
+    };
+
+    /*!
+       \brief Measures the time of a phase in its lifetime
+
+       Usually used by the QWT_PICKER2_SAMPLE macro.
+     */
+    class Sampler
+    {
+      public:
+        Sampler( QwtPicker2Statistics*, Phase );
+        ~Sampler();
+
+      private:
+        QwtPicker2Statistics* m_statistics;
+        const Phase m_phase;
+        QElapsedTimer m_timer;
+    };
+
+    QwtPicker2Statistics();
+
+    void reset();
+    void addSample( Phase, qint64 nsecs );
+
+    qint64 count( Phase ) const;
+    qint64 totalTime( Phase ) const;
+    qint64 maxTime( Phase ) const;
+    qint64 averageTime( Phase ) const;
+
+    qint64 bucketCount( Phase, int bucket ) const;
+    static qint64 bucketLimit( int bucket );
+
+    static const char* phaseName( Phase );
+
+  private:
+    struct PhaseData
+    {
+        qint64 count;
+        qint64 total;
+        qint64 max;
+        qint64 buckets[ BucketCount ];
+    };
+
+    PhaseData m_phases[ PhaseCount ];
+};
+
+#ifdef QWT_PICKER2_STATISTICS
+#define QWT_PICKER2_SAMPLE( statistics, phase ) \
+    const QwtPicker2Statistics::Sampler qwtPicker2Sampler( \
+        statistics, QwtPicker2Statistics::phase )
+#else
+#define QWT_PICKER2_SAMPLE( statistics, phase )
+#endif
+
+/*!
+   Start measuring
+
+   \param statistics Statistics, where to add the sample, might be NULL
+   \param phase Phase to be measured
+ */
+inline QwtPicker2Statistics::Sampler::Sampler(
+        QwtPicker2Statistics* statistics, Phase phase )
+    : m_statistics( statistics )
+    , m_phase( phase )
+{
+    if ( m_statistics )
+        m_timer.start();
+}
+
+//! Add the elapsed time as sample
+inline QwtPicker2Statistics::Sampler::~Sampler()
+{
+    if ( m_statistics )
+        m_statistics->addSample( m_phase, m_timer.nsecsElapsed() );
+}
+
+#endif
@@ -0,0 +1,323 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_picker_trace2.h"
+
+#include <qfile.h>
+#include <qthread.h>
+#include <qatomic.h>
+#include <qelapsedtimer.h>
+#include <qbytearray.h>
+#include <qcoreapplication.h>
+
+namespace
+{
+    class Event
+    {
+      public:
+        const char* name;
+        qint64 timestamp; // us
+        qint64 duration;  // us
+        quintptr id;
+        int state;
+        int size;
+    };
+
+    /*
+        A ring buffer with one producer ( the thread adding events )
+        and one consumer ( the writer thread ). The counters are only
+        incremented: the producer owns head, the consumer owns tail.
+        fetchAndAddOrdered( 0 ) is used as an ordered load, as Qt 4
+        has no loadAcquire().
+     */
+    class EventBuffer
+    {
+      public:
+        enum { Capacity = 1 << 14 };
+
+        EventBuffer()
+            : m_head( 0 )
+            , m_tail( 0 )
+            , m_dropped( 0 )
+        {
+        }
+
+        bool push( const Event& event )
+        {
+            const uint head = uint( m_head.fetchAndAddOrdered( 0 ) );
+            const uint tail = uint( m_tail.fetchAndAddOrdered( 0 ) );
+
+            if ( head - tail >= uint( Capacity ) )
+            {
+                m_dropped.fetchAndAddOrdered( 1 );
+                return false;
+            }
+
+            m_events[ head & ( Capacity - 1 ) ] = event;
+
+            // publishing the event
+            m_head.fetchAndAddOrdered( 1 );
+
+            return true;
+        }
+
+        int pop( Event* events, int maxCount )
+        {
+            const uint head = uint( m_head.fetchAndAddOrdered( 0 ) );
+            const uint tail = uint( m_tail.fetchAndAddOrdered( 0 ) );
+
+            const int count = qMin( int( head - tail ), maxCount );
+            for ( int i = 0; i < count; i++ )
+                events[i] = m_events[ ( tail + i ) & ( Capacity - 1 ) ];
+
+            // releasing the slots
+            m_tail.fetchAndAddOrdered( count );
+
+            return count;
+        }
+
+        int dropped() const
+        {
+            return const_cast< QAtomicInt& >( m_dropped ).fetchAndAddOrdered( 0 );
+        }
+
+      private:
+        Event m_events[ Capacity ];
+
+        QAtomicInt m_head;
+        QAtomicInt m_tail;
+        QAtomicInt m_dropped;
+    };
+
+    class Writer : public QThread
+    {
+      public:
+        Writer( EventBuffer* buffer, QFile* file )
+            : m_buffer( buffer )
+            , m_file( file )
+            , m_pid( QCoreApplication::applicationPid() )
+            , m_hasEvents( false )
+            , m_isStopped( 0 )
+        {
+        }
+
+        void stop()
+        {
+            m_isStopped.fetchAndStoreOrdered( 1 );
+            wait();
+        }
+
+      protected:
+        virtual void run() QWT_OVERRIDE
+        {
+            for ( ;; )
+            {
+                const bool isStopped = m_isStopped.fetchAndAddOrdered( 0 ) != 0;
+
+                flush();
+
+                if ( isStopped )
+                    break;
+
+                msleep( 50 );
+            }
+        }
+
+      private:
+        void flush()
+        {
+            enum { BatchSize = 256 };
+            Event events[ BatchSize ];
+
+            QByteArray json;
+
+            int count;
+            while ( ( count = m_buffer->pop( events, BatchSize ) ) > 0 )
+            {
+                for ( int i = 0; i < count; i++ )
+                    appendEvent( events[i], json );
+            }
+
+            if ( !json.isEmpty() )
+            {
+                m_file->write( json );
+                m_file->flush();
+            }
+        }
+
+        void appendEvent( const Event& event, QByteArray& json )
+        {
+            json += m_hasEvents ? ",\n" : "\n";
+            m_hasEvents = true;
+
+            json += "{\"name\":\"";
+            json += event.name;
+            json += "\",\"cat\":\"QwtPicker2\",\"ph\":\"X\",\"ts\":";
+            json += QByteArray::number( event.timestamp );
+            json += ",\"dur\":";
+            json += QByteArray::number( event.duration );
+            json += ",\"pid\":";
+            json += QByteArray::number( m_pid );
+            json += ",\"tid\":1,\"args\":{";
+
+            bool hasArgs = false;
+
+            if ( event.id != 0 )
+            {
+                json += "\"id\":\"0x";
+                json += QByteArray::number( qulonglong( event.id ), 16 );
+                json += "\"";
+                hasArgs = true;
+            }
+
+            if ( event.state >= 0 )
+            {
+                json += hasArgs ? ",\"state\":" : "\"state\":";
+                json += QByteArray::number( event.state );
+                hasArgs = true;
+            }
+
+            if ( event.size >= 0 )
+            {
+                json += hasArgs ? ",\"size\":" : "\"size\":";
+                json += QByteArray::number( event.size );
+            }
+
+            json += "}}";
+        }
+
+        EventBuffer* m_buffer;
+        QFile* m_file;
+
+        const qint64 m_pid;
+        bool m_hasEvents;
+
+        QAtomicInt m_isStopped;
+    };
+}
+
+class QwtPicker2Trace::PrivateData
+{
+  public:
+    PrivateData():
+        writer( NULL )
+    {
+    }
+
+    QFile file;
+    QElapsedTimer clock;
+
+    EventBuffer buffer;
+    Writer* writer;
+};
+
+/*!
+   \brief Constructor
+
+   The file is opened and the writer thread is started.
+
+   \param fileName Name of the JSON file
+   \param parent Parent object
+
+   \sa isOpen()
+ */
+QwtPicker2Trace::QwtPicker2Trace( const QString& fileName, QObject* parent )
+    : QObject( parent )
+{
+    m_data = new PrivateData;
+    m_data->clock.start();
+
+    m_data->file.setFileName( fileName );
+    if ( m_data->file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        // JSON array format: the closing bracket is optional
+        m_data->file.write( "[" );
+
+        m_data->writer = new Writer( &m_data->buffer, &m_data->file );
+        m_data->writer->start( QThread::LowPriority );
+    }
+}
+
+/*!
+   Destructor
+
+   The pending events are written and the file is closed.
+ */
+QwtPicker2Trace::~QwtPicker2Trace()
+{
+    if ( m_data->writer )
+    {
+        m_data->writer->stop();
+        delete m_data->writer;
+
+        m_data->file.write( "\n]\n" );
+        m_data->file.close();
+    }
+
+    delete m_data;
+}
+
+//! \return True, when the file could be opened
+bool QwtPicker2Trace::isOpen() const
+{
+    return m_data->writer != NULL;
+}
+
+//! \return Name of the JSON file
+QString QwtPicker2Trace::fileName() const
+{
+    return m_data->file.fileName();
+}
+
+//! \return Microseconds since the trace has been created
+qint64 QwtPicker2Trace::timestamp() const
+{
+    return m_data->clock.nsecsElapsed() / 1000;
+}
+
+/*!
+   \brief Add a complete event
+
+   The event is copied into the buffer and written later by
+   the writer thread. When the buffer is full it is dropped.
+
+   \param name Name of the event, a string literal: only the
+               pointer is stored and it must not contain quotes
+   \param timestamp Start of the event in microseconds
+   \param duration Duration of the event in microseconds
+   \param id Object, that is passed as argument, usually the picker
+   \param state State argument, ignored when < 0
+   \param size Size argument, ignored when < 0
+
+   \sa timestamp(), droppedEvents(), Scope
+ */
+void QwtPicker2Trace::addEvent( const char* name, qint64 timestamp,
+    qint64 duration, const void* id, int state, int size )
+{
+    if ( m_data->writer == NULL )
+        return;
+
+    Event event;
+    event.name = name;
+    event.timestamp = timestamp;
+    event.duration = duration;
+    event.id = quintptr( id );
+    event.state = state;
+    event.size = size;
+
+    m_data->buffer.push( event );
+}
+
+//! \return Number of events, that have been dropped because of a full buffer
+int QwtPicker2Trace::droppedEvents() const
+{
+    return m_data->buffer.dropped();
+}
+
+#include "moc_qwt_picker_trace2.cpp"
@@ -0,0 +1,142 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PICKER_TRACE2_H
+#define QWT_PICKER_TRACE2_H
+
+#include "qwt_global.h"
+#include <qobject.h>
+
+class QString;
+
+/*!
+   \brief A writer for Chrome trace events
+
+   QwtPicker2Trace writes the activity of pickers as trace events
+   in the JSON format of Chrome, that can be loaded into about:tracing
+   or Perfetto. A picker writes its commands, the updates of its
+   display and the paint operations of its overlays, when a trace has
+   been assigned by QwtPicker2::setTrace(). The state of the state
+   machine and the number of picked points are passed as arguments.
+
+   Adding an event only copies it into a lock free ring buffer.
+   Formatting and writing is done by a thread, that flushes the buffer
+   periodically. When the buffer is full, events are dropped.
+
+   Events have to be added from one thread - usually the GUI thread.
+   Applications can add events of their own, f.e. for replots, to see
+   them on the same timeline:
+
+   \code
+    QwtPicker2Trace* trace = new QwtPicker2Trace( "picker.json", plot );
+    picker->setTrace( trace );
+
+    ...
+
+    {
+        QwtPicker2Trace::Scope scope( trace, "replot" );
+        plot->replot();
+    }
+   \endcode
+
+   \sa QwtPicker2::setTrace()
+ */
+class QWT_EXPORT QwtPicker2Trace : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /*!
+       \brief A complete event for the lifetime of the scope
+
+       The trace might be NULL, what disables the scope.
+       The name has to be a string literal: only the pointer is stored.
+     */
+    class Scope
+    {
+      public:
+        Scope( QwtPicker2Trace*, const char* name,
+            const void* id = NULL, int state = -1, int size = -1 );
+
+        ~Scope();
+
+        void setArguments( int state, int size );
+
+      private:
+        QwtPicker2Trace* m_trace;
+        const char* m_name;
+        const void* m_id;
+        int m_state;
+        int m_size;
+        qint64 m_timestamp;
+    };
+
+    explicit QwtPicker2Trace( const QString& fileName, QObject* parent = NULL );
+    virtual ~QwtPicker2Trace();
+
+    bool isOpen() const;
+    QString fileName() const;
+
+    qint64 timestamp() const;
+
+    void addEvent( const char* name, qint64 timestamp, qint64 duration,
+        const void* id = NULL, int state = -1, int size = -1 );
+
+    int droppedEvents() const;
+
+  private:
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+/*!
+   Start the event
+
+   \param trace Trace, might be NULL
+   \param name Name of the event, a string literal
+   \param id Object, that is passed as argument, usually the picker
+   \param state State argument, ignored when < 0
+   \param size Size argument, ignored when < 0
+ */
+inline QwtPicker2Trace::Scope::Scope( QwtPicker2Trace* trace,
+        const char* name, const void* id, int state, int size )
+    : m_trace( trace )
+    , m_name( name )
+    , m_id( id )
+    , m_state( state )
+    , m_size( size )
+    , m_timestamp( 0 )
+{
+    if ( m_trace )
+        m_timestamp = m_trace->timestamp();
+}
+
+//! Add the event to the trace
+inline QwtPicker2Trace::Scope::~Scope()
+{
+    if ( m_trace )
+    {
+        m_trace->addEvent( m_name, m_timestamp,
+            m_trace->timestamp() - m_timestamp, m_id, m_state, m_size );
+    }
+}
+
+/*!
+   Set the arguments of the event
+
+   \param state State argument, ignored when < 0
+   \param size Size argument, ignored when < 0
+ */
+inline void QwtPicker2Trace::Scope::setArguments( int state, int size )
+{
+    m_state = state;
+    m_size = size;
+}
+
+#endif
@@ -9,22 +9,387 @@
 
 #include "qwt_plot_picker2.h"
 #include "qwt_plot.h"
+#include "qwt_plot_curve.h"
+#include "qwt_series_data.h"
+#include "qwt_scale_widget.h"
+#include "qwt_scale_draw.h"
+#include "qwt_plot_layout.h"
 #include "qwt_text.h"
 #include "qwt_scale_div.h"
 #include "qwt_scale_map.h"
+#include "qwt_transform.h"
+#include "qwt_math.h"
 #include "qwt_picker_machine2.h"
+#include "qwt_picker_statistics2.h"
+
+#include <qevent.h>
+#include <qpolygon.h>
+#include <qmetaobject.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // signals, that need a conversion into plot coordinates
+    enum PlotSignal
+    {
+        AppendedSignal,
+        MovedSignal,
+        SelectedPointSignal,
+        SelectedRectSignal,
+        SelectedPolygonSignal
+    };
+
+    /*
+        The coefficients of a QwtScaleMap, calculated in the same
+        way as in QwtScaleMap, so that the bulk operations return
+        exactly the same values as QwtScaleMap::transform()/invTransform()
+     */
+    class MapCoefficients
+    {
+      public:
+        explicit MapCoefficients( const QwtScaleMap& map )
+            : transformation( map.transformation() )
+            , ts1( map.s1() )
+            , p1( map.p1() )
+            , cnv( 1.0 )
+        {
+            double ts2 = map.s2();
+
+            if ( transformation )
+            {
+                ts1 = transformation->transform( ts1 );
+                ts2 = transformation->transform( ts2 );
+            }
+
+            if ( ts1 != ts2 )
+                cnv = ( map.p2() - p1 ) / ( ts2 - ts1 );
+        }
+
+        const QwtTransform* transformation;
+        double ts1;
+        double p1;
+        double cnv;
+    };
+
+    // a node of the k-d tree for snapping
+    class SnapSample
+    {
+      public:
+        double x;
+        double y;
+        int curve; // index in PrivateData::snapCurves
+    };
+
+    // a curve of the k-d tree and what is used to detect data changes
+    class SnapCurve
+    {
+      public:
+        bool hasSameData( const SnapCurve& other ) const
+        {
+            return curve == other.curve && data == other.data
+                && size == other.size && boundingRect == other.boundingRect;
+        }
+
+        const QwtPlotCurve* curve;
+        const QwtSeriesData< QPointF >* data;
+        size_t size;
+        QRectF boundingRect;
+        bool isVisible;
+    };
+
+    class LessX
+    {
+      public:
+        inline bool operator()( const SnapSample& s1, const SnapSample& s2 ) const
+        {
+            return s1.x < s2.x;
+        }
+    };
+
+    class LessY
+    {
+      public:
+        inline bool operator()( const SnapSample& s1, const SnapSample& s2 ) const
+        {
+            return s1.y < s2.y;
+        }
+    };
+
+    /*
+        Nearest neighbour search in the k-d tree, measuring the distances
+        in pixels. As the scale transformations are monotonic, the pixel
+        distance to a splitting line is a lower bound for the distances
+        of all samples on its other side - also for non linear scales.
+     */
+    class NearestSearch
+    {
+      public:
+        NearestSearch( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                const SnapCurve* curves, const QPoint& pos, int maxDistance )
+            : m_xMap( xMap )
+            , m_yMap( yMap )
+            , m_curves( curves )
+            , m_pos( pos )
+            , m_value( xMap.invTransform( pos.x() ), yMap.invTransform( pos.y() ) )
+            , m_distance2( std::numeric_limits< double >::max() )
+            , m_nearest( NULL )
+        {
+            if ( maxDistance > 0 )
+                m_distance2 = double( maxDistance ) * maxDistance;
+        }
+
+        void search( const SnapSample* samples, int count, int depth )
+        {
+            if ( count <= 0 )
+                return;
+
+            const int mid = count / 2;
+            const SnapSample& sample = samples[mid];
+
+            const double dx = m_xMap.transform( sample.x ) - m_pos.x();
+            const double dy = m_yMap.transform( sample.y ) - m_pos.y();
+
+            if ( m_curves[sample.curve].isVisible )
+            {
+                const double distance2 = dx * dx + dy * dy;
+                if ( distance2 <= m_distance2 )
+                {
+                    m_distance2 = distance2;
+                    m_nearest = &sample;
+                }
+            }
+
+            const bool isX = ( depth % 2 ) == 0;
+
+            const bool isLower = isX
+                ? ( m_value.x() < sample.x ) : ( m_value.y() < sample.y );
+
+            const SnapSample* lower = samples;
+            const int lowerCount = mid;
+
+            const SnapSample* upper = samples + mid + 1;
+            const int upperCount = count - mid - 1;
+
+            if ( isLower )
+                search( lower, lowerCount, depth + 1 );
+            else
+                search( upper, upperCount, depth + 1 );
+
+            const double d = isX ? dx : dy;
+            if ( d * d <= m_distance2 )
+            {
+                if ( isLower )
+                    search( upper, upperCount, depth + 1 );
+                else
+                    search( lower, lowerCount, depth + 1 );
+            }
+        }
+
+        const SnapSample* nearest() const
+        {
+            return m_nearest;
+        }
+
+      private:
+        const QwtScaleMap& m_xMap;
+        const QwtScaleMap& m_yMap;
+        const SnapCurve* m_curves;
+
+        const QPoint m_pos;
+        const QPointF m_value;
+
+        double m_distance2;
+        const SnapSample* m_nearest;
+    };
+
+    /*
+        The parameters of QwtPlot::canvasMap() for an axis, that can be
+        read without allocations. Comparing them detects modifications,
+        that happen without notifying the picker: f.e. changes of the
+        border distances or canvas margins, or resizes of the canvas,
+        while the picker is disabled.
+     */
+    class AxisGeometry
+    {
+      public:
+        AxisGeometry()
+            : transformation( NULL )
+            , s1( 0.0 )
+            , s2( 0.0 )
+            , p1( 0.0 )
+            , p2( 0.0 )
+            , isVisible( false )
+            , canvasMargin( 0 )
+        {
+        }
+
+        AxisGeometry( const QwtPlot* plot, QwtAxisId axisId )
+            : transformation( NULL )
+            , s1( 0.0 )
+            , s2( 0.0 )
+            , p1( 0.0 )
+            , p2( 0.0 )
+            , isVisible( plot->isAxisVisible( axisId ) )
+            , canvasMargin( plot->plotLayout()->canvasMargin( axisId ) )
+        {
+            const QwtScaleWidget* scaleWidget = plot->axisWidget( axisId );
+            if ( scaleWidget )
+            {
+                // updated by QwtPlot::updateAxes() and the layout
+                const QwtScaleMap& map = scaleWidget->scaleDraw()->scaleMap();
+
+                transformation = map.transformation();
+                s1 = map.s1();
+                s2 = map.s2();
+                p1 = map.p1();
+                p2 = map.p2();
+
+                geometry = scaleWidget->geometry();
+            }
+        }
+
+        bool operator==( const AxisGeometry& other ) const
+        {
+            return ( transformation == other.transformation )
+                && ( s1 == other.s1 ) && ( s2 == other.s2 )
+                && ( p1 == other.p1 ) && ( p2 == other.p2 )
+                && ( isVisible == other.isVisible )
+                && ( canvasMargin == other.canvasMargin )
+                && ( geometry == other.geometry );
+        }
+
+        bool operator!=( const AxisGeometry& other ) const
+        {
+            return !( *this == other );
+        }
+
+      private:
+        const QwtTransform* transformation;
+        double s1;
+        double s2;
+        double p1;
+        double p2;
+        bool isVisible;
+        int canvasMargin;
+        QRect geometry;
+    };
+}
+
+static void qwtBuildKdTree( SnapSample* samples, int count, int depth )
+{
+    if ( count <= 1 )
+        return;
+
+    const int mid = count / 2;
+
+    if ( depth % 2 == 0 )
+        std::nth_element( samples, samples + mid, samples + count, LessX() );
+    else
+        std::nth_element( samples, samples + mid, samples + count, LessY() );
+
+    qwtBuildKdTree( samples, mid, depth + 1 );
+    qwtBuildKdTree( samples + mid + 1, count - mid - 1, depth + 1 );
+}
+
+static void qwtInvTransform( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QPoint* points, int count, QPointF* values )
+{
+    const MapCoefficients mx( xMap );
+    const MapCoefficients my( yMap );
+
+    /*
+        The linear part is a simple loop without any branches or function
+        calls, that can be vectorized by the compiler. Non linear
+        transformations are applied in a second pass.
+     */
+
+    for ( int i = 0; i < count; i++ )
+    {
+        values[i].rx() = mx.ts1 + ( points[i].x() - mx.p1 ) / mx.cnv;
+        values[i].ry() = my.ts1 + ( points[i].y() - my.p1 ) / my.cnv;
+    }
+
+    if ( mx.transformation )
+    {
+        for ( int i = 0; i < count; i++ )
+            values[i].rx() = mx.transformation->invTransform( values[i].x() );
+    }
+
+    if ( my.transformation )
+    {
+        for ( int i = 0; i < count; i++ )
+            values[i].ry() = my.transformation->invTransform( values[i].y() );
+    }
+}
+
+static void qwtTransform( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QPointF* values, int count, QPoint* points )
+{
+    const MapCoefficients mx( xMap );
+    const MapCoefficients my( yMap );
+
+    for ( int i = 0; i < count; i++ )
+    {
+        double x = values[i].x();
+        if ( mx.transformation )
+            x = mx.transformation->transform( x );
+
+        double y = values[i].y();
+        if ( my.transformation )
+            y = my.transformation->transform( y );
+
+        const QPointF p( mx.p1 + ( x - mx.ts1 ) * mx.cnv,
+            my.p1 + ( y - my.ts1 ) * my.cnv );
+
+        points[i] = p.toPoint();
+    }
+}
 
 class QwtPlotPicker2::PrivateData
 {
   public:
     PrivateData():
         xAxisId( -1 ),
-        yAxisId( -1 )
+        yAxisId( -1 ),
+        scaleMapsValid( false ),
+        snapping( false ),
+        snapDistance( 0 ),
+        snapIndexValid( false )
     {
     }
 
     QwtAxisId xAxisId;
     QwtAxisId yAxisId;
+
+    // snapshot of plot()->canvasMap() for xAxisId/yAxisId
+    bool scaleMapsValid;
+    QwtScaleMap xMap;
+    QwtScaleMap yMap;
+
+    // the parameters, that have been used for xMap/yMap
+    AxisGeometry xGeometry;
+    AxisGeometry yGeometry;
+    QRect canvasGeometry;
+    QRect canvasContentsRect;
+
+    bool snapping;
+    int snapDistance;
+
+    // k-d tree of the samples of the curves, built on demand
+    bool snapIndexValid;
+    QVector< SnapCurve > snapCurves;
+    QVector< SnapSample > snapSamples;
+
+    /*
+        The points of the previous adjustedPoints(), their snapped
+        positions and the exact samples in plot coordinates, that are
+        emitted instead of inverting the rounded positions.
+     */
+    QPolygon snapInput;
+    QPolygon snapOutput;
+    QPolygonF snapValues;
 };
 
 /*!
@@ -79,6 +444,9 @@ QwtPlotPicker2::QwtPlotPicker2( QwtAxisId xAxisId, QwtAxisId yAxisId, QWidget* c
     m_data = new PrivateData;
     m_data->xAxisId = xAxisId;
     m_data->yAxisId = yAxisId;
+
+    if ( plot() )
+        watchAxes( true );
 }
 
 /*!
@@ -102,6 +470,9 @@ QwtPlotPicker2::QwtPlotPicker2( QwtAxisId xAxisId, QwtAxisId yAxisId,
     m_data = new PrivateData;
     m_data->xAxisId = xAxisId;
     m_data->yAxisId = yAxisId;
+
+    if ( plot() )
+        watchAxes( true );
 }
 
 //! Destructor
@@ -177,8 +548,15 @@ void QwtPlotPicker2::setAxes( QwtAxisId xAxisId, QwtAxisId yAxisId )
 
     if ( xAxisId != m_data->xAxisId || yAxisId != m_data->yAxisId )
     {
+        watchAxes( false );
+
         m_data->xAxisId = xAxisId;
         m_data->yAxisId = yAxisId;
+
+        watchAxes( true );
+
+        m_data->snapIndexValid = false;
+        invalidateScaleMaps();
     }
 }
 
@@ -194,6 +572,392 @@ QwtAxisId QwtPlotPicker2::yAxis() const
     return m_data->yAxisId;
 }
 
+/*!
+   \brief En/Disable snapping
+
+   When snapping is enabled, adjustedPoints() moves the picked points
+   to the nearest samples of the visible curves, that are attached to
+   xAxis() and yAxis(). The tracker text shows the snapped sample.
+
+   The samples are indexed in a k-d tree, that is built, when needed.
+   It is rebuilt, when curves are attached/detached or when the data
+   object, the size or the bounding rectangle of the samples of a curve
+   have been changed. Modifications in place, that are not detected
+   this way, need to be announced by invalidateSnapIndex().
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa snapping(), setSnapDistance(), nearestSample()
+ */
+void QwtPlotPicker2::setSnapping( bool on )
+{
+    if ( m_data->snapping == on )
+        return;
+
+    m_data->snapping = on;
+
+    if ( !on )
+    {
+        // releasing the memory of the index
+        m_data->snapCurves.clear();
+        m_data->snapSamples.clear();
+        m_data->snapIndexValid = false;
+    }
+
+    m_data->snapInput.clear();
+    m_data->snapOutput.clear();
+    m_data->snapValues.clear();
+
+    invalidateTrackerText();
+
+    if ( isActive() || trackerMode() == AlwaysOn )
+        updateDisplay();
+}
+
+/*!
+   \return True, when snapping is enabled
+   \sa setSnapping()
+ */
+bool QwtPlotPicker2::snapping() const
+{
+    return m_data->snapping;
+}
+
+/*!
+   Set the maximum distance between a position and a sample,
+   that it is snapped to. Positions without samples in this
+   distance are not modified.
+
+   The default setting is 0, what means no limit.
+
+   \param pixels Distance in pixels, <= 0 means no limit
+   \sa snapDistance(), setSnapping()
+ */
+void QwtPlotPicker2::setSnapDistance( int pixels )
+{
+    m_data->snapDistance = qMax( pixels, 0 );
+
+    m_data->snapInput.clear();
+    m_data->snapOutput.clear();
+    m_data->snapValues.clear();
+
+    invalidateTrackerText();
+}
+
+/*!
+   \return Maximum distance in pixels for snapping, 0 means no limit
+   \sa setSnapDistance()
+ */
+int QwtPlotPicker2::snapDistance() const
+{
+    return m_data->snapDistance;
+}
+
+/*!
+   Rebuild the index for snapping, when it is needed the next time
+
+   The index detects most changes of the curves on its own, but
+   not modifications of the samples in place.
+
+   \sa setSnapping()
+ */
+void QwtPlotPicker2::invalidateSnapIndex()
+{
+    m_data->snapIndexValid = false;
+    invalidateTrackerText();
+}
+
+/*!
+   \brief Find the nearest sample
+
+   Finds the sample of the visible curves attached to xAxis() and yAxis(),
+   that is closest to a position in pixels, within snapDistance().
+
+   \param pos Position in pixel coordinates
+   \param sample Nearest sample in plot coordinates
+   \return True, when a sample has been found
+
+   \sa setSnapping(), setSnapDistance()
+ */
+bool QwtPlotPicker2::nearestSample( const QPoint& pos, QPointF& sample ) const
+{
+    if ( plot() == NULL )
+        return false;
+
+    updateScaleMaps();
+
+    // the curves are checked for modifications by eventFilter()
+    if ( !m_data->snapIndexValid )
+        updateSnapIndex();
+
+    if ( m_data->snapSamples.isEmpty() )
+        return false;
+
+    NearestSearch search( m_data->xMap, m_data->yMap,
+        m_data->snapCurves.constData(), pos, m_data->snapDistance );
+
+    search.search( m_data->snapSamples.constData(),
+        m_data->snapSamples.size(), 0 );
+
+    const SnapSample* nearest = search.nearest();
+    if ( nearest == NULL )
+        return false;
+
+    sample = QPointF( nearest->x, nearest->y );
+    return true;
+}
+
+/*!
+   Rebuild the index for snapping, when the curves have been changed
+
+   \return True, when the index has been rebuilt or the
+           visibility of a curve has changed
+ */
+bool QwtPlotPicker2::updateSnapIndex() const
+{
+    QVector< SnapCurve >& curves = m_data->snapCurves;
+
+    bool isValid = m_data->snapIndexValid;
+    bool isVisibilityChanged = false;
+    int numCurves = 0;
+
+    // itemList( rtti ) would allocate a list for each check
+    const QwtPlotItemList& items = plot()->itemList();
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        if ( items[i]->rtti() != QwtPlotItem::Rtti_PlotCurve )
+            continue;
+
+        const QwtPlotCurve* curve = static_cast< const QwtPlotCurve* >( items[i] );
+        if ( curve->xAxis() != xAxis() || curve->yAxis() != yAxis() )
+            continue;
+
+        SnapCurve snapCurve;
+        snapCurve.curve = curve;
+        snapCurve.data = curve->data();
+        snapCurve.size = snapCurve.data->size();
+        snapCurve.boundingRect = snapCurve.data->boundingRect();
+        snapCurve.isVisible = curve->isVisible();
+
+        if ( isValid && numCurves < curves.size()
+            && snapCurve.hasSameData( curves[numCurves] ) )
+        {
+            // the visibility of the curves is checked, when searching
+            if ( curves[numCurves].isVisible != snapCurve.isVisible )
+            {
+                curves[numCurves].isVisible = snapCurve.isVisible;
+                isVisibilityChanged = true;
+            }
+        }
+        else
+        {
+            isValid = false;
+
+            if ( numCurves < curves.size() )
+                curves[numCurves] = snapCurve;
+            else
+                curves += snapCurve;
+        }
+
+        numCurves++;
+    }
+
+    if ( numCurves != curves.size() )
+    {
+        isValid = false;
+        curves.resize( numCurves );
+    }
+
+    if ( isValid )
+    {
+        if ( isVisibilityChanged )
+        {
+            m_data->snapInput.clear();
+            m_data->snapOutput.clear();
+            m_data->snapValues.clear();
+        }
+
+        return isVisibilityChanged;
+    }
+
+    size_t numSamples = 0;
+    for ( int i = 0; i < curves.size(); i++ )
+        numSamples += curves[i].size;
+
+    QVector< SnapSample >& samples = m_data->snapSamples;
+
+    samples.clear();
+    samples.reserve( int( numSamples ) );
+
+    for ( int i = 0; i < curves.size(); i++ )
+    {
+        const QwtSeriesData< QPointF >* data = curves[i].data;
+
+        for ( size_t j = 0; j < curves[i].size; j++ )
+        {
+            const QPointF p = data->sample( j );
+            if ( qIsNaN( p.x() ) || qIsNaN( p.y() ) )
+                continue;
+
+            SnapSample snapSample;
+            snapSample.x = p.x();
+            snapSample.y = p.y();
+            snapSample.curve = i;
+
+            samples += snapSample;
+        }
+    }
+
+    qwtBuildKdTree( samples.data(), samples.size(), 0 );
+    m_data->snapIndexValid = true;
+
+    m_data->snapInput.clear();
+    m_data->snapOutput.clear();
+    m_data->snapValues.clear();
+
+    return true;
+}
+
+/*!
+   \brief Event filter
+
+   Invalidates the cached scale maps, when the geometry of the canvas
+   or of one of the axes has changed, before the event is processed
+   by QwtPicker2::eventFilter(). When snapping is enabled, the curves
+   are checked for modifications once for each event of the canvas
+   instead of doing it for each lookup.
+
+   \param object Object to be filtered
+   \param event Event
+
+   \return See QwtPicker2::eventFilter()
+ */
+bool QwtPlotPicker2::eventFilter( QObject* object, QEvent* event )
+{
+    if ( object && ( event->type() == QEvent::Resize
+        || event->type() == QEvent::Move ) )
+    {
+        if ( object == canvas() )
+        {
+            invalidateScaleMaps();
+        }
+        else
+        {
+            const QwtPlot* plt = plot();
+            if ( plt && ( object == plt->axisWidget( xAxis() )
+                || object == plt->axisWidget( yAxis() ) ) )
+            {
+                invalidateScaleMaps();
+            }
+        }
+    }
+
+    if ( m_data->snapping && m_data->snapIndexValid
+        && object && object == canvas() )
+    {
+        if ( updateSnapIndex() )
+            invalidateTrackerText();
+    }
+
+    return QwtPicker2::eventFilter( object, event );
+}
+
+/*!
+   Connect to the scale widgets of the axes to be notified
+   about changes of the scale maps
+
+   \param on Connect when true, disconnect otherwise
+ */
+void QwtPlotPicker2::watchAxes( bool on )
+{
+    QwtPlot* plt = plot();
+    if ( plt == NULL )
+        return;
+
+    const QwtAxisId axes[] = { xAxis(), yAxis() };
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        QwtScaleWidget* scaleWidget = plt->axisWidget( axes[i] );
+        if ( scaleWidget == NULL )
+            continue;
+
+        if ( on )
+        {
+            connect( scaleWidget, SIGNAL(scaleDivChanged()),
+                this, SLOT(invalidateScaleMaps()) );
+            scaleWidget->installEventFilter( this );
+        }
+        else
+        {
+            disconnect( scaleWidget, SIGNAL(scaleDivChanged()),
+                this, SLOT(invalidateScaleMaps()) );
+            scaleWidget->removeEventFilter( this );
+        }
+    }
+}
+
+/*!
+   Invalidate the cached scale maps
+
+   The maps are recalculated from QwtPlot::canvasMap(), when they
+   are needed the next time. Changes of the geometry of the canvas
+   or the axes are also detected, when the maps are used.
+ */
+void QwtPlotPicker2::invalidateScaleMaps()
+{
+    m_data->scaleMapsValid = false;
+
+    // the pixel positions of the samples have changed
+    m_data->snapInput.clear();
+    m_data->snapOutput.clear();
+    m_data->snapValues.clear();
+
+    invalidateTrackerText();
+}
+
+/*!
+   Recalculate the scale maps, when they have been invalidated
+   or the geometry of the canvas or the axes has been changed
+ */
+void QwtPlotPicker2::updateScaleMaps() const
+{
+    const QwtPlot* plt = plot();
+    const QWidget* cnv = plt->canvas();
+
+    const AxisGeometry xGeometry( plt, xAxis() );
+    const AxisGeometry yGeometry( plt, yAxis() );
+
+    const QRect canvasGeometry = cnv ? cnv->geometry() : QRect();
+    const QRect canvasContentsRect = cnv ? cnv->contentsRect() : QRect();
+
+    if ( m_data->scaleMapsValid )
+    {
+        if ( xGeometry == m_data->xGeometry && yGeometry == m_data->yGeometry
+            && canvasGeometry == m_data->canvasGeometry
+            && canvasContentsRect == m_data->canvasContentsRect )
+        {
+            return;
+        }
+
+        // modified without notification: the pixel positions have changed
+        m_data->snapInput.clear();
+        m_data->snapOutput.clear();
+        m_data->snapValues.clear();
+    }
+
+    m_data->xMap = plt->canvasMap( xAxis() );
+    m_data->yMap = plt->canvasMap( yAxis() );
+
+    m_data->xGeometry = xGeometry;
+    m_data->yGeometry = yGeometry;
+    m_data->canvasGeometry = canvasGeometry;
+    m_data->canvasContentsRect = canvasContentsRect;
+
+    m_data->scaleMapsValid = true;
+}
+
 /*!
    Translate a pixel position into a position string
 
@@ -205,9 +969,73 @@ QwtText QwtPlotPicker2::trackerText( const QPoint& pos ) const
     if ( plot() == NULL )
         return QwtText();
 
+    QPointF sample;
+    if ( m_data->snapping && nearestSample( pos, sample ) )
+        return trackerTextF( sample );
+
     return trackerTextF( invTransform( pos ) );
 }
 
+/*!
+   \brief Map the picked points to the selection
+
+   When snapping is enabled, the points are moved to the
+   pixel positions of their nearest samples.
+
+   As usually only the last point has been appended or moved,
+   the positions of the previous call are reused for the unchanged
+   points, so that only the modified points need to be looked up.
+
+   \param points Picked points
+   \return Selected points
+   \sa setSnapping(), nearestSample()
+ */
+QPolygon QwtPlotPicker2::adjustedPoints( const QPolygon& points ) const
+{
+    if ( !m_data->snapping || plot() == NULL )
+        return QwtPicker2::adjustedPoints( points );
+
+    updateScaleMaps();
+
+    if ( !m_data->snapIndexValid )
+        updateSnapIndex(); // clears the positions of the previous call
+
+    const QPolygon& input = m_data->snapInput;
+
+    const int numPoints = points.size();
+    const int maxCount = qMin( numPoints, input.size() );
+
+    int count = 0;
+    while ( count < maxCount && points[count] == input[count] )
+        count++;
+
+    QPolygon adjusted = m_data->snapOutput;
+    adjusted.resize( numPoints );
+
+    QPolygonF& values = m_data->snapValues;
+    values.resize( numPoints );
+
+    for ( int i = count; i < numPoints; i++ )
+    {
+        QPointF sample;
+        if ( nearestSample( points[i], sample ) )
+        {
+            adjusted[i] = transform( sample );
+            values[i] = sample;
+        }
+        else
+        {
+            adjusted[i] = points[i];
+            values[i] = invTransform( points[i] );
+        }
+    }
+
+    m_data->snapInput = points;
+    m_data->snapOutput = adjusted;
+
+    return adjusted;
+}
+
 /*!
    \brief Translate a position into a position string
 
@@ -251,22 +1079,60 @@ QwtText QwtPlotPicker2::trackerTextF( const QPointF& pos ) const
 void QwtPlotPicker2::append( const QPoint& pos )
 {
     QwtPicker2::append( pos );
-    Q_EMIT appended( invTransform( pos ) );
+
+    if ( hasReceivers( AppendedSignal ) )
+    {
+        QWT_PICKER2_SAMPLE( statistics(), SignalEmission );
+        Q_EMIT appended( snappedPosition( pos ) );
+    }
 }
 
 /*!
-   Move the last point of the selection
+   Emit the moved() signals for the last point of the selection
 
-   \param pos New position
-   \sa isActive, begin(), end(), append()
+   \param pos Position of the moved last point
+   \sa move(), setSignalDelivery()
 
    \note The moved(const QPoint &), moved(const QDoublePoint &)
         signals are emitted.
  */
-void QwtPlotPicker2::move( const QPoint& pos )
+void QwtPlotPicker2::notifyMoved( const QPoint& pos )
 {
-    QwtPicker2::move( pos );
-    Q_EMIT moved( invTransform( pos ) );
+    QwtPicker2::notifyMoved( pos );
+
+    if ( hasReceivers( MovedSignal ) )
+        Q_EMIT moved( snappedPosition( pos ) );
+}
+
+/*!
+   \brief Translate a picked position into plot coordinates
+
+   When snapping is enabled, the exact coordinates of the nearest sample
+   are returned instead of inverting its position, that has been
+   rounded to pixels.
+
+   \param pos Picked position in pixel coordinates
+   \return Position in plot coordinates
+ */
+QPointF QwtPlotPicker2::snappedPosition( const QPoint& pos ) const
+{
+    if ( m_data->snapping && plot() )
+    {
+        // usually the last point has been snapped by adjustedPoints() before
+
+        const QPolygon& input = m_data->snapInput;
+        if ( !input.isEmpty() && input.last() == pos
+            && m_data->snapValues.size() == input.size() )
+        {
+            return m_data->snapValues.last();
+        }
+
+        QPointF sample;
+        if ( nearestSample( pos, sample ) )
+            return sample;
+    }
+
+    return invTransform( pos );
 }
 
 /*!
@@ -297,11 +1163,44 @@ bool QwtPlotPicker2::end( bool ok )
     if ( stateMachine() )
         selectionType = stateMachine()->selectionType();
 
+    // no conversions, when nobody is interested in the result
+
+    bool isConnected = false;
+    switch ( selectionType )
+    {
+        case QwtPicker2Machine::PointSelection:
+            isConnected = hasReceivers( SelectedPointSignal );
+            break;
+        case QwtPicker2Machine::RectSelection:
+            isConnected = hasReceivers( SelectedRectSignal );
+            break;
+        case QwtPicker2Machine::PolygonSelection:
+            isConnected = hasReceivers( SelectedPolygonSignal );
+            break;
+        default:
+            break;
+    }
+
+    if ( !isConnected )
+        return true;
+
+    QWT_PICKER2_SAMPLE( statistics(), SignalEmission );
+
+    /*
+        The selection has been snapped by adjustedPoints():
+        the exact samples are emitted instead of inverting the
+        rounded pixel positions.
+     */
+    const bool isSnapped = m_data->snapping && ( points == m_data->snapOutput )
+        && ( m_data->snapValues.size() == points.size() );
+
     switch ( selectionType )
     {
         case QwtPicker2Machine::PointSelection:
         {
-            const QPointF pos = invTransform( points.first() );
+            const QPointF pos = isSnapped
+                ? m_data->snapValues.first() : invTransform( points.first() );
+
             Q_EMIT selected( pos );
             break;
         }
@@ -309,21 +1208,35 @@ bool QwtPlotPicker2::end( bool ok )
         {
             if ( points.count() >= 2 )
             {
-                const QPoint p1 = points.first();
-                const QPoint p2 = points.last();
-
-                const QRect rect = QRect( p1, p2 ).normalized();
-                Q_EMIT selected( invTransform( rect ) );
+                if ( isSnapped )
+                {
+                    const QRectF rect( m_data->snapValues.first(),
+                        m_data->snapValues.last() );
+
+                    Q_EMIT selected( rect.normalized() );
+                }
+                else
+                {
+                    const QPoint p1 = points.first();
+                    const QPoint p2 = points.last();
+
+                    const QRect rect = QRect( p1, p2 ).normalized();
+                    Q_EMIT selected( invTransform( rect ) );
+                }
             }
             break;
         }
         case QwtPicker2Machine::PolygonSelection:
         {
-            QVector< QPointF > dpa( points.count() );
-            for ( int i = 0; i < points.count(); i++ )
-                dpa[i] = invTransform( points[i] );
-
-            Q_EMIT selected( dpa );
+            if ( isSnapped )
+            {
+                const QVector< QPointF > samples = m_data->snapValues;
+                Q_EMIT selected( samples );
+            }
+            else
+            {
+                Q_EMIT selected( invTransform( points ) );
+            }
         }
         default:
             break;
@@ -332,6 +1245,75 @@ bool QwtPlotPicker2::end( bool ok )
     return true;
 }
 
+/*!
+   Check if a signal, that needs a conversion into
+   plot coordinates, is connected
+
+   \param signal Signal, see PlotSignal
+   \return True, when the signal has receivers
+ */
+bool QwtPlotPicker2::hasReceivers( int signal ) const
+{
+#if QT_VERSION >= 0x050000
+    typedef void ( QwtPlotPicker2::* PointSignal )( const QPointF& );
+    typedef void ( QwtPlotPicker2::* RectSignal )( const QRectF& );
+    typedef void ( QwtPlotPicker2::* PolygonSignal )( const QVector< QPointF >& );
+
+    QMetaMethod method;
+    switch ( signal )
+    {
+        case AppendedSignal:
+            method = QMetaMethod::fromSignal(
+                static_cast< PointSignal >( &QwtPlotPicker2::appended ) );
+            break;
+        case MovedSignal:
+            method = QMetaMethod::fromSignal(
+                static_cast< PointSignal >( &QwtPlotPicker2::moved ) );
+            break;
+        case SelectedPointSignal:
+            method = QMetaMethod::fromSignal(
+                static_cast< PointSignal >( &QwtPlotPicker2::selected ) );
+            break;
+        case SelectedRectSignal:
+            method = QMetaMethod::fromSignal(
+                static_cast< RectSignal >( &QwtPlotPicker2::selected ) );
+            break;
+        case SelectedPolygonSignal:
+            method = QMetaMethod::fromSignal(
+                static_cast< PolygonSignal >( &QwtPlotPicker2::selected ) );
+            break;
+        default:
+            return true;
+    }
+
+    return isSignalConnected( method );
+#else
+    const char* signature = NULL;
+    switch ( signal )
+    {
+        case AppendedSignal:
+            signature = SIGNAL( appended( const QPointF& ) );
+            break;
+        case MovedSignal:
+            signature = SIGNAL( moved( const QPointF& ) );
+            break;
+        case SelectedPointSignal:
+            signature = SIGNAL( selected( const QPointF& ) );
+            break;
+        case SelectedRectSignal:
+            signature = SIGNAL( selected( const QRectF& ) );
+            break;
+        case SelectedPolygonSignal:
+            signature = SIGNAL( selected( const QVector< QPointF >& ) );
+            break;
+        default:
+            return true;
+    }
+
+    return receivers( signature ) > 0;
+#endif
+}
+
 /*!
     Translate a rectangle from pixel into plot coordinates
 
@@ -340,10 +1322,8 @@ bool QwtPlotPicker2::end( bool ok )
  */
 QRectF QwtPlotPicker2::invTransform( const QRect& rect ) const
 {
-    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
-    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
-
-    return QwtScaleMap::invTransform( xMap, yMap, rect );
+    updateScaleMaps();
+    return QwtScaleMap::invTransform( m_data->xMap, m_data->yMap, rect );
 }
 
 /*!
@@ -353,10 +1333,8 @@ QRectF QwtPlotPicker2::invTransform( const QRect& rect ) const
  */
 QRect QwtPlotPicker2::transform( const QRectF& rect ) const
 {
-    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
-    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
-
-    return QwtScaleMap::transform( xMap, yMap, rect ).toRect();
+    updateScaleMaps();
+    return QwtScaleMap::transform( m_data->xMap, m_data->yMap, rect ).toRect();
 }
 
 /*!
@@ -366,12 +1344,11 @@ QRect QwtPlotPicker2::transform( const QRectF& rect ) const
  */
 QPointF QwtPlotPicker2::invTransform( const QPoint& pos ) const
 {
-    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
-    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
+    updateScaleMaps();
 
     return QPointF(
-        xMap.invTransform( pos.x() ),
-        yMap.invTransform( pos.y() )
+        m_data->xMap.invTransform( pos.x() ),
+        m_data->yMap.invTransform( pos.y() )
         );
 }
 
@@ -382,12 +1359,51 @@ QPointF QwtPlotPicker2::invTransform( const QPoint& pos ) const
  */
 QPoint QwtPlotPicker2::transform( const QPointF& pos ) const
 {
-    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
-    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
+    updateScaleMaps();
 
-    const QPointF p( xMap.transform( pos.x() ), yMap.transform( pos.y() ) );
+    const QPointF p( m_data->xMap.transform( pos.x() ),
+        m_data->yMap.transform( pos.y() ) );
 
     return p.toPoint();
 }
 
+/*!
+    Translate points from pixel into plot coordinates
+
+    For selections with many points this is faster than
+    translating each point with invTransform( const QPoint& ).
+
+    \param points Points in pixel coordinates
+    \return Points in plot coordinates
+    \sa transform()
+ */
+QVector< QPointF > QwtPlotPicker2::invTransform( const QPolygon& points ) const
+{
+    updateScaleMaps();
+
+    QVector< QPointF > values( points.size() );
+    qwtInvTransform( m_data->xMap, m_data->yMap,
+        points.constData(), points.size(), values.data() );
+
+    return values;
+}
+
+/*!
+    Translate points from plot into pixel coordinates
+
+    \param values Points in plot coordinates
+    \return Points in pixel coordinates
+    \sa invTransform()
+ */
+QPolygon QwtPlotPicker2::transform( const QVector< QPointF >& values ) const
+{
+    updateScaleMaps();
+
+    QPolygon points( values.size() );
+    qwtTransform( m_data->xMap, m_data->yMap,
+        values.constData(), values.size(), points.data() );
+
+    return points;
+}
+
 #include "moc_qwt_plot_picker2.cpp"
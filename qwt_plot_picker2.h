@@ -17,6 +17,7 @@
 class QwtPlot;
 class QPointF;
 class QRectF;
+class QPolygon;
 
 #if QT_VERSION < 0x060000
 template< typename T > class QVector;
@@ -28,6 +29,13 @@ template< typename T > class QVector;
    QwtPlotPicker is a QwtPicker2 tailored for selections on
    a plot canvas. It is set to a x-Axis and y-Axis and
    translates all pixel coordinates into this coordinate system.
+
+   When snapping is enabled, the picked points are moved to the nearest
+   samples of the curves, that are attached to the axes of the picker.
+   The samples are organized in a k-d tree, so that the costs
+   of a lookup are logarithmic in the number of samples.
+
+   \sa setSnapping()
  */
 
 class QWT_EXPORT QwtPlotPicker2 : public QwtPicker2
@@ -54,6 +62,18 @@ class QWT_EXPORT QwtPlotPicker2 : public QwtPicker2
     QWidget* canvas();
     const QWidget* canvas() const;
 
+    void setSnapping( bool );
+    bool snapping() const;
+
+    void setSnapDistance( int pixels );
+    int snapDistance() const;
+
+    void invalidateSnapIndex();
+
+    bool nearestSample( const QPoint&, QPointF& sample ) const;
+
+    virtual bool eventFilter( QObject*, QEvent* ) QWT_OVERRIDE;
+
   Q_SIGNALS:
 
     /*!
@@ -102,14 +122,29 @@ class QWT_EXPORT QwtPlotPicker2 : public QwtPicker2
     QPointF invTransform( const QPoint& ) const;
     QPoint transform( const QPointF& ) const;
 
+    QVector< QPointF > invTransform( const QPolygon& ) const;
+    QPolygon transform( const QVector< QPointF >& ) const;
+
+    virtual QPolygon adjustedPoints( const QPolygon& ) const QWT_OVERRIDE;
+
     virtual QwtText trackerText( const QPoint& ) const QWT_OVERRIDE;
     virtual QwtText trackerTextF( const QPointF& ) const;
 
-    virtual void move( const QPoint& ) QWT_OVERRIDE;
+    virtual void notifyMoved( const QPoint& ) QWT_OVERRIDE;
     virtual void append( const QPoint& ) QWT_OVERRIDE;
     virtual bool end( bool ok = true ) QWT_OVERRIDE;
 
+  private Q_SLOTS:
+    void invalidateScaleMaps();
+
   private:
+    void watchAxes( bool on );
+    void updateScaleMaps() const;
+    bool updateSnapIndex() const;
+    QPointF snappedPosition( const QPoint& ) const;
+
+    bool hasReceivers( int signal ) const;
+
     class PrivateData;
     PrivateData* m_data;
 };